@@ -0,0 +1,171 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "AssetLoader.hpp"
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <condition_variable>
+
+namespace Engine3D
+{
+    namespace
+    {
+        std::mutex                        g_decode_mutex;
+        std::condition_variable           g_decode_signal;
+        std::deque<std::function<void()>> g_decode_jobs;
+        std::vector<std::thread>          g_workers;
+        u32                               g_decode_running { 0 };
+        bool                              g_stopping       { false };
+
+        std::mutex                        g_upload_mutex;
+        std::deque<std::function<void()>> g_upload_jobs;
+
+        /**
+         * take decode jobs until the loader is destroyed
+         */
+        void workerLoop()
+        {
+            while (true)
+            {
+                std::function<void()> job;
+
+                {
+                    std::unique_lock<std::mutex> lock(g_decode_mutex);
+                    g_decode_signal.wait(lock, [] { return g_stopping || g_decode_jobs.empty() == false; });
+
+                    if (g_stopping)
+                    {
+                        return;
+                    }
+
+                    job = std::move(g_decode_jobs.front());
+                    g_decode_jobs.pop_front();
+                    g_decode_running++;
+                }
+
+                job();
+
+                std::lock_guard<std::mutex> lock(g_decode_mutex);
+                g_decode_running--;
+            }
+        }
+    }
+
+    /**
+     * run the job on one of the worker threads
+     */
+    void AssetLoader::decode(std::function<void()> job)
+    {
+        std::lock_guard<std::mutex> lock(g_decode_mutex);
+
+        //one core is left to the gl thread
+        if (g_workers.empty())
+        {
+            u32 count = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+            g_stopping = false;
+
+            for (u32 i = 0; i < count; i++)
+            {
+                g_workers.emplace_back(workerLoop);
+            }
+        }
+
+        g_decode_jobs.push_back(std::move(job));
+        g_decode_signal.notify_one();
+    }
+
+    /**
+     * run the job on the gl thread during one of the next update() calls
+     */
+    void AssetLoader::upload(std::function<void()> job)
+    {
+        std::lock_guard<std::mutex> lock(g_upload_mutex);
+        g_upload_jobs.push_back(std::move(job));
+    }
+
+    /**
+     * run queued uploads until the budget runs out
+     */
+    void AssetLoader::update(float budget)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        while (true)
+        {
+            std::function<void()> job;
+
+            {
+                std::lock_guard<std::mutex> lock(g_upload_mutex);
+
+                if (g_upload_jobs.empty())
+                {
+                    return;
+                }
+
+                job = std::move(g_upload_jobs.front());
+                g_upload_jobs.pop_front();
+            }
+
+            job();
+
+            if (std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() >= budget)
+            {
+                return;
+            }
+        }
+    }
+
+    /**
+     * get number of jobs waiting for a worker or for the upload
+     */
+    u32 AssetLoader::pending()
+    {
+        std::lock_guard<std::mutex> decode_lock(g_decode_mutex);
+        std::lock_guard<std::mutex> upload_lock(g_upload_mutex);
+
+        return static_cast<u32>(g_decode_jobs.size() + g_upload_jobs.size()) + g_decode_running;
+    }
+
+    /**
+     * stop the workers
+     */
+    void AssetLoader::destroy()
+    {
+        {
+            std::lock_guard<std::mutex> lock(g_decode_mutex);
+            g_stopping = true;
+            g_decode_jobs.clear();
+        }
+
+        g_decode_signal.notify_all();
+
+        for (auto& worker : g_workers)
+        {
+            worker.join();
+        }
+
+        g_workers.clear();
+
+        std::lock_guard<std::mutex> lock(g_upload_mutex);
+        g_upload_jobs.clear();
+    }
+};
\ No newline at end of file
@@ -0,0 +1,61 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <functional>
+
+#include "Types.hpp"
+
+namespace Engine3D
+{
+    /**
+     * two stage asset loading, files are decoded on worker threads and the results are handed
+     * to the gl thread, which uploads them a few at a time every frame
+     */
+    namespace AssetLoader
+    {
+        /**
+         * time spent on the uploads in one frame in seconds, one upload is always done so the queue keeps moving
+         */
+        constexpr float DefaultUploadBudget = 0.004f;
+
+        /**
+         * run the job on one of the worker threads, the workers are started with the first job
+         */
+        void decode(std::function<void()> job);
+
+        /**
+         * run the job on the gl thread during one of the next update() calls, can be called from any thread
+         */
+        void upload(std::function<void()> job);
+
+        /**
+         * run queued uploads until the budget runs out, called once per frame from the gl thread
+         */
+        void update(float budget = DefaultUploadBudget);
+
+        /**
+         * get number of jobs waiting for a worker or for the upload
+         */
+        u32 pending();
+
+        /**
+         * stop the workers, jobs that haven't started are dropped
+         */
+        void destroy();
+    };
+};
\ No newline at end of file
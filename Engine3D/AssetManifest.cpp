@@ -0,0 +1,184 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "AssetManifest.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <stdexcept>
+#include <cstdio>
+
+#include "File.hpp"
+#include "System.hpp"
+#include "CacheTelemetry.hpp"
+
+namespace Engine3D
+{
+    namespace
+    {
+        /**
+         * prefetchers of the named caches by cache name, the manifest lines name the cache that loads each file,
+         * a local static so the global caches can register while they are constructed
+         */
+        std::unordered_map<std::string, AssetManifest::Prefetcher>& registry()
+        {
+            static std::unordered_map<std::string, AssetManifest::Prefetcher> caches;
+            return caches;
+        }
+
+        std::vector<std::function<void()>> g_prefetched;
+
+        bool                                g_recording { false };
+        std::vector<std::string>            g_recorded; //lines of the manifest in the order the files were looked up
+        std::unordered_set<std::string>     g_recorded_set;
+    }
+
+    /**
+     * register cache under its name
+     */
+    void AssetManifest::track(const std::string& cache, Prefetcher prefetcher)
+    {
+        registry()[cache] = std::move(prefetcher);
+    }
+
+    void AssetManifest::untrack(const std::string& cache)
+    {
+        registry().erase(cache);
+    }
+
+    /**
+     * start loading the files of the manifest
+     */
+    void AssetManifest::prefetch(const std::string& path)
+    {
+        File input(System::getFullPath(path), File::OpenMode::Read);
+
+        if (input.isFile() == false)
+        {
+            return;
+        }
+
+        std::string text = input.readText();
+        input.close();
+
+        CacheTelemetry::Requester requester("prefetch");
+
+        u64 start = 0;
+
+        while (start < text.size())
+        {
+            u64 end = text.find('\n', start);
+
+            if (end == std::string::npos)
+            {
+                end = text.size();
+            }
+
+            std::string line = text.substr(start, end - start);
+            start = end + 1;
+
+            while (line.empty() == false && (line.back() == '\r' || line.back() == '\0'))
+            {
+                line.pop_back();
+            }
+
+            u64  tab = line.find('\t');
+            auto it  = tab == std::string::npos ? registry().end() : registry().find(line.substr(0, tab));
+
+            if (it == registry().end())
+            {
+                continue;
+            }
+
+            //a file missing since the manifest was saved is reported and skipped, the game reports it again if it still needs it
+            try
+            {
+                g_prefetched.push_back(it->second(line.substr(tab + 1)));
+            }
+            catch (const std::runtime_error& error)
+            {
+                std::printf("AssetManifest::prefetch() error: %s - %s\n", error.what(), line.c_str());
+            }
+        }
+    }
+
+    /**
+     * release the data loaded by prefetch()
+     */
+    void AssetManifest::release()
+    {
+        for (auto& release : g_prefetched)
+        {
+            release();
+        }
+
+        g_prefetched.clear();
+    }
+
+    /**
+     * start recording files looked up by the caches
+     */
+    void AssetManifest::record()
+    {
+        g_recording = true;
+        g_recorded.clear();
+        g_recorded_set.clear();
+    }
+
+    /**
+     * add file into the recording
+     */
+    void AssetManifest::touch(const std::string& cache, const char* path)
+    {
+        if (g_recording == false)
+        {
+            return;
+        }
+
+        std::string line = cache + "\t" + path;
+
+        if (g_recorded_set.insert(line).second)
+        {
+            g_recorded.push_back(std::move(line));
+        }
+    }
+
+    /**
+     * stop recording and write the manifest
+     */
+    void AssetManifest::save(const std::string& path)
+    {
+        g_recording = false;
+
+        File output(System::getFullPath(path), File::OpenMode::Write);
+
+        if (output.failed())
+        {
+            throw std::runtime_error("AssetManifest::save() error: cannot open output file");
+        }
+
+        for (auto& line : g_recorded)
+        {
+            output.write(line + "\n");
+        }
+
+        output.close();
+
+        g_recorded.clear();
+        g_recorded_set.clear();
+    }
+};
\ No newline at end of file
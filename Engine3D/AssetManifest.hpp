@@ -0,0 +1,75 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <string>
+#include <functional>
+
+#include "Types.hpp"
+
+namespace Engine3D
+{
+    /**
+     * list of the files the game loads during its initialization, saved after the initialization and read on the next
+     * launch to start loading them all at once, the asynchronous caches decode them in parallel on the loader workers
+     *
+     * the manifest is a text file, every line holds the name of the cache and the path separated by a tab
+     */
+    namespace AssetManifest
+    {
+        /**
+         * manifest used by the game
+         */
+        constexpr const char* DefaultPath = "data/startup.manifest";
+
+        /**
+         * function that starts loading the path and returns the function releasing the loaded data
+         */
+        using Prefetcher = std::function<std::function<void()>(const std::string&)>;
+
+        /**
+         * register cache under its name, done by the cache itself
+         */
+        void track(const std::string& cache, Prefetcher prefetcher);
+        void untrack(const std::string& cache);
+
+        /**
+         * start loading the files of the manifest, the data is kept until release(), missing manifest is ignored
+         */
+        void prefetch(const std::string& path);
+
+        /**
+         * release the data loaded by prefetch(), data taken by the game meanwhile stays loaded
+         */
+        void release();
+
+        /**
+         * start recording files looked up by the caches
+         */
+        void record();
+
+        /**
+         * add file into the recording, called by the caches
+         */
+        void touch(const std::string& cache, const char* path);
+
+        /**
+         * stop recording and write the recorded files into the manifest
+         */
+        void save(const std::string& path);
+    };
+};
\ No newline at end of file
@@ -0,0 +1,236 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "BoundingVolumeHierarchy.hpp"
+
+#include <limits>
+#include <numeric>
+
+namespace Engine3D
+{
+    namespace
+    {
+        BoundingBox emptyBox()
+        {
+            return BoundingBox(glm::vec3( std::numeric_limits<float>::max()),
+                               glm::vec3(-std::numeric_limits<float>::max()));
+        }
+
+        void grow(BoundingBox& box, const BoundingBox& other)
+        {
+            box.min = glm::min(box.min, other.min);
+            box.max = glm::max(box.max, other.max);
+        }
+
+        void grow(BoundingBox& box, const glm::vec3& point)
+        {
+            box.min = glm::min(box.min, point);
+            box.max = glm::max(box.max, point);
+        }
+    }
+
+    /**
+     * build the hierarchy using surface area heuristic over binned centroids
+     */
+    void BoundingVolumeHierarchy::build(const std::vector<Triangle>& triangles)
+    {
+        clear();
+
+        if (triangles.empty())
+        {
+            return;
+        }
+
+        std::vector<BoundingBox> boxes(triangles.size());
+        std::vector<glm::vec3>   centroids(triangles.size());
+
+        for (u32 i = 0; i < triangles.size(); i++)
+        {
+            const Triangle& triangle = triangles[i];
+
+            boxes[i].min = glm::min(triangle.p1, glm::min(triangle.p2, triangle.p3));
+            boxes[i].max = glm::max(triangle.p1, glm::max(triangle.p2, triangle.p3));
+            centroids[i] = (boxes[i].min + boxes[i].max) * 0.5f;
+        }
+
+        m_triangles.resize(triangles.size());
+        std::iota(m_triangles.begin(), m_triangles.end(), 0);
+
+        //a binary tree with n leaves has 2n - 1 nodes
+        m_nodes.reserve(2 * ((triangles.size() + MaxLeafSize - 1) / MaxLeafSize));
+
+        Node root;
+        root.first = 0;
+        root.count = static_cast<u32>(triangles.size());
+        m_nodes.push_back(root);
+
+        split(0, boxes, centroids, 0);
+    }
+
+    /**
+     * remove all nodes
+     */
+    void BoundingVolumeHierarchy::clear()
+    {
+        m_nodes.clear();
+        m_triangles.clear();
+        m_depth = 0;
+    }
+
+    /**
+     * split the triangles [first, first + count) of the node and build its children
+     */
+    void BoundingVolumeHierarchy::split(u32 node_index, const std::vector<BoundingBox>& boxes, const std::vector<glm::vec3>& centroids, u32 depth)
+    {
+        u32 first = m_nodes[node_index].first;
+        u32 count = m_nodes[node_index].count;
+
+        BoundingBox box          = emptyBox();
+        BoundingBox centroid_box = emptyBox();
+
+        for (u32 i = first; i < first + count; i++)
+        {
+            grow(box, boxes[m_triangles[i]]);
+            grow(centroid_box, centroids[m_triangles[i]]);
+        }
+
+        m_nodes[node_index].box = box;
+        m_depth = std::max(m_depth, depth);
+
+        //the traversal stacks hold one branch per level
+        if (count <= MaxLeafSize || depth + 1 >= StackSize)
+        {
+            return;
+        }
+
+        //find the best split plane among the bins of every axis
+        float best_cost  = std::numeric_limits<float>::max();
+        u32   best_axis  = 0;
+        u32   best_split = 0;
+
+        for (u32 axis = 0; axis < 3; axis++)
+        {
+            float extent = centroid_box.max[axis] - centroid_box.min[axis];
+
+            if (extent <= 0.0f)
+            {
+                continue;
+            }
+
+            BoundingBox bin_boxes[BinCount];
+            u32         bin_counts[BinCount] = {};
+
+            for (u32 i = 0; i < BinCount; i++)
+            {
+                bin_boxes[i] = emptyBox();
+            }
+
+            float scale = BinCount / extent;
+
+            for (u32 i = first; i < first + count; i++)
+            {
+                u32 bin = std::min(static_cast<u32>((centroids[m_triangles[i]][axis] - centroid_box.min[axis]) * scale), BinCount - 1);
+
+                bin_counts[bin]++;
+                grow(bin_boxes[bin], boxes[m_triangles[i]]);
+            }
+
+            //sweep from the right to get the cost of every right side
+            float       right_areas[BinCount];
+            u32         right_counts[BinCount];
+            BoundingBox right_box   = emptyBox();
+            u32         right_count = 0;
+
+            for (u32 i = BinCount - 1; i > 0; i--)
+            {
+                grow(right_box, bin_boxes[i]);
+                right_count += bin_counts[i];
+
+                right_areas[i]  = area(right_box);
+                right_counts[i] = right_count;
+            }
+
+            BoundingBox left_box   = emptyBox();
+            u32         left_count = 0;
+
+            for (u32 i = 0; i < BinCount - 1; i++)
+            {
+                grow(left_box, bin_boxes[i]);
+                left_count += bin_counts[i];
+
+                if (left_count == 0 || right_counts[i + 1] == 0)
+                {
+                    continue;
+                }
+
+                float cost = area(left_box) * left_count + right_areas[i + 1] * right_counts[i + 1];
+
+                if (cost < best_cost)
+                {
+                    best_cost  = cost;
+                    best_axis  = axis;
+                    best_split = i + 1;
+                }
+            }
+        }
+
+        u32 middle;
+
+        //splitting doesn't pay off -> keep the leaf unless it is way too big
+        if (best_cost >= area(box) * count && count <= MaxLeafSize * 4)
+        {
+            return;
+        }
+
+        if (best_cost != std::numeric_limits<float>::max())
+        {
+            float extent = centroid_box.max[best_axis] - centroid_box.min[best_axis];
+            float scale  = BinCount / extent;
+
+            u32* split_point = std::partition(m_triangles.data() + first, m_triangles.data() + first + count, [&](u32 triangle)
+                {
+                    u32 bin = std::min(static_cast<u32>((centroids[triangle][best_axis] - centroid_box.min[best_axis]) * scale), BinCount - 1);
+                    return bin < best_split;
+                });
+
+            middle = static_cast<u32>(split_point - m_triangles.data());
+        }
+        //all centroids in one point -> split in half
+        else
+        {
+            middle = first + count / 2;
+        }
+
+        u32 left_index = static_cast<u32>(m_nodes.size());
+
+        Node left;
+        left.first = first;
+        left.count = middle - first;
+
+        Node right;
+        right.first = middle;
+        right.count = first + count - middle;
+
+        m_nodes.push_back(left);
+        m_nodes.push_back(right);
+
+        m_nodes[node_index].first = left_index;
+        m_nodes[node_index].count = 0;
+
+        split(left_index,     boxes, centroids, depth + 1);
+        split(left_index + 1, boxes, centroids, depth + 1);
+    }
+};
\ No newline at end of file
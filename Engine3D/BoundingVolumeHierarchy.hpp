@@ -0,0 +1,306 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <vector>
+#include <type_traits>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+#include "Types.hpp"
+#include "Shapes.hpp"
+#include "SpatialPartition.hpp"
+
+namespace Engine3D
+{
+    /**
+     * bounding volume hierarchy over the triangles of a mesh
+     *
+     * built once from the triangles in mesh space, the nodes are stored in one array,
+     * children of an inner node sit next to each other and leaves reference a range
+     * of triangle indices
+     */
+    class BoundingVolumeHierarchy
+    {
+    public:
+
+        static constexpr u32 MaxLeafSize = 4;
+        static constexpr u32 StackSize   = 64;
+        static constexpr u32 BinCount    = 12;
+
+        /**
+         * node of the hierarchy
+         *
+         * inner node - count == 0, children are at first and first + 1
+         * leaf       - count != 0, triangles are m_triangles[first .. first + count)
+         */
+        struct Node
+        {
+            BoundingBox box;
+            u32         first { 0 };
+            u32         count { 0 };
+
+            bool leaf() const { return count != 0; }
+        };
+
+        /**
+         * constructors
+         */
+        BoundingVolumeHierarchy() {}
+        BoundingVolumeHierarchy(const std::vector<Triangle>& triangles) { build(triangles); }
+
+        /**
+         * build the hierarchy using surface area heuristic over binned centroids
+         *
+         * \note - triangle indices passed to the callbacks are indices into this vector
+         */
+        void build(const std::vector<Triangle>& triangles);
+
+        /**
+         * take over nodes built earlier, used when the hierarchy is loaded from a cooked mesh
+         */
+        void assign(std::vector<Node>&& nodes, std::vector<u32>&& triangles, u32 depth)
+        {
+            m_nodes     = std::move(nodes);
+            m_triangles = std::move(triangles);
+            m_depth     = depth;
+        }
+
+        /**
+         * remove all nodes
+         */
+        void clear();
+
+        /**
+         * check if the hierarchy has any triangles
+         */
+        bool empty() const { return m_nodes.empty(); }
+
+        /**
+         * get the box around all triangles
+         */
+        const BoundingBox& bounds() const { return m_nodes.front().box; }
+
+        /**
+         * get nodes, the root is the first one
+         */
+        const std::vector<Node>& nodes() const { return m_nodes; }
+
+        /**
+         * get triangle indices referenced by the leaves
+         */
+        const std::vector<u32>& triangles() const { return m_triangles; }
+
+        /**
+         * get depth of the deepest leaf
+         */
+        u32 depth() const { return m_depth; }
+
+        /**
+         * visit every triangle whose box overlaps the box
+         *
+         * \arg callback - void(u32) or bool(u32) taking the triangle index, returning false stops the query
+         */
+        template<typename F>
+        void queryBox(const BoundingBox& box, F&& callback) const
+        {
+            traverse([&](const Node& node) { return overlaps(node.box, box); }, callback);
+        }
+
+        /**
+         * visit every triangle whose box is crossed by the segment from ray.pos to ray.pos + ray.dir
+         *
+         * \arg callback - void(u32) or bool(u32) taking the triangle index, returning false stops the query
+         */
+        template<typename F>
+        void queryRay(const Ray& ray, F&& callback) const
+        {
+            glm::vec3 inv_dir = 1.0f / ray.dir;
+
+            traverse([&](const Node& node) { return crosses(node.box, ray.pos, inv_dir); }, callback);
+        }
+
+        /**
+         * visit every triangle in the leaves accepted by the node test
+         *
+         * \arg test     - bool(const Node&), false skips the whole subtree
+         * \arg callback - void(u32) or bool(u32) taking the triangle index, returning false stops the query
+         */
+        template<typename G, typename F>
+        void traverse(G&& test, F&& callback) const
+        {
+            if (m_nodes.empty())
+            {
+                return;
+            }
+
+            u32 stack[StackSize];
+            u32 stack_size = 0;
+
+            stack[stack_size++] = 0;
+
+            while (stack_size != 0)
+            {
+                const Node& node = m_nodes[stack[--stack_size]];
+
+                if (!test(node))
+                {
+                    continue;
+                }
+
+                if (!node.leaf())
+                {
+                    stack[stack_size++] = node.first + 1;
+                    stack[stack_size++] = node.first;
+                    continue;
+                }
+
+                for (u32 i = node.first; i < node.first + node.count; i++)
+                {
+                    if constexpr (std::is_same_v<std::invoke_result_t<F&, u32>, bool>)
+                    {
+                        if (!callback(m_triangles[i]))
+                        {
+                            return;
+                        }
+                    }
+                    else
+                    {
+                        callback(m_triangles[i]);
+                    }
+                }
+            }
+        }
+
+        /**
+         * visit every pair of triangles from two hierarchies whose leaves pass the node test,
+         * both trees are descended together so only overlapping branches are opened
+         *
+         * \arg test     - bool(const Node&, const Node&) for a node of the first and of the second tree
+         * \arg callback - void(u32, u32) or bool(u32, u32) taking the triangle indices, returning false stops the query
+         */
+        template<typename G, typename F>
+        static void traversePairs(const BoundingVolumeHierarchy& first, const BoundingVolumeHierarchy& second, G&& test, F&& callback)
+        {
+            if (first.m_nodes.empty() || second.m_nodes.empty())
+            {
+                return;
+            }
+
+            struct NodePair { u32 first; u32 second; };
+
+            NodePair stack[StackSize * 2];
+            u32      stack_size = 0;
+
+            stack[stack_size++] = { 0, 0 };
+
+            while (stack_size != 0)
+            {
+                NodePair    pair  = stack[--stack_size];
+                const Node& node1 = first.m_nodes[pair.first];
+                const Node& node2 = second.m_nodes[pair.second];
+
+                if (!test(node1, node2))
+                {
+                    continue;
+                }
+
+                if (node1.leaf() && node2.leaf())
+                {
+                    for (u32 i = node1.first; i < node1.first + node1.count; i++)
+                    {
+                        for (u32 j = node2.first; j < node2.first + node2.count; j++)
+                        {
+                            if constexpr (std::is_same_v<std::invoke_result_t<F&, u32, u32>, bool>)
+                            {
+                                if (!callback(first.m_triangles[i], second.m_triangles[j]))
+                                {
+                                    return;
+                                }
+                            }
+                            else
+                            {
+                                callback(first.m_triangles[i], second.m_triangles[j]);
+                            }
+                        }
+                    }
+                    continue;
+                }
+
+                //open the bigger node, leaves can't be opened
+                if (!node1.leaf() && (node2.leaf() || area(node1.box) >= area(node2.box)))
+                {
+                    stack[stack_size++] = { node1.first + 1, pair.second };
+                    stack[stack_size++] = { node1.first,     pair.second };
+                }
+                else
+                {
+                    stack[stack_size++] = { pair.first, node2.first + 1 };
+                    stack[stack_size++] = { pair.first, node2.first     };
+                }
+            }
+        }
+
+        /**
+         * box vs box overlap
+         */
+        static bool overlaps(const BoundingBox& box1, const BoundingBox& box2)
+        {
+            return box1.min.x <= box2.max.x && box2.min.x <= box1.max.x &&
+                   box1.min.y <= box2.max.y && box2.min.y <= box1.max.y &&
+                   box1.min.z <= box2.max.z && box2.min.z <= box1.max.z;
+        }
+
+        /**
+         * half of the surface area of the box
+         */
+        static float area(const BoundingBox& box)
+        {
+            glm::vec3 d = box.max - box.min;
+            return d.x * d.y + d.y * d.z + d.z * d.x;
+        }
+
+        /**
+         * segment vs box using the slab test, the segment goes from pos to pos + 1 / inv_dir
+         */
+        static bool crosses(const BoundingBox& box, const glm::vec3& pos, const glm::vec3& inv_dir)
+        {
+            glm::vec3 t1 = (box.min - pos) * inv_dir;
+            glm::vec3 t2 = (box.max - pos) * inv_dir;
+
+            glm::vec3 t_near = glm::min(t1, t2);
+            glm::vec3 t_far  = glm::max(t1, t2);
+
+            float enter = std::max(std::max(t_near.x, t_near.y), std::max(t_near.z, 0.0f));
+            float exit  = std::min(std::min(t_far.x, t_far.y), std::min(t_far.z, 1.0f));
+
+            return enter <= exit;
+        }
+
+    private:
+
+        /**
+         * split the triangles [first, first + count) of the node and build its children
+         */
+        void split(u32 node_index, const std::vector<BoundingBox>& boxes, const std::vector<glm::vec3>& centroids, u32 depth);
+
+        std::vector<Node> m_nodes;
+        std::vector<u32>  m_triangles;
+        u32               m_depth { 0 };
+    };
+};
\ No newline at end of file
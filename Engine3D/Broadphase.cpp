@@ -0,0 +1,120 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "Broadphase.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace Engine3D
+{
+    /**
+     * compute overlapping pairs
+     */
+    const std::vector<Broadphase::Pair>& Broadphase::update(const std::vector<BoundingBox>& boxes)
+    {
+        m_pairs.clear();
+
+        u32 axis = dominantAxis(boxes);
+
+        //number of boxes or the axis changed -> the old order is useless
+        if (m_order.size() != boxes.size() || axis != m_axis)
+        {
+            m_order.resize(boxes.size());
+            std::iota(m_order.begin(), m_order.end(), 0);
+            std::sort(m_order.begin(), m_order.end(), [&](u32 a, u32 b) { return boxes[a].min[axis] < boxes[b].min[axis]; });
+
+            m_axis = axis;
+        }
+        //insertion sort, linear for the almost sorted order from the last tick
+        else
+        {
+            for (u32 i = 1; i < m_order.size(); i++)
+            {
+                u32   index = m_order[i];
+                float value = boxes[index].min[axis];
+                u32   j     = i;
+
+                while (j > 0 && boxes[m_order[j - 1]].min[axis] > value)
+                {
+                    m_order[j] = m_order[j - 1];
+                    j--;
+                }
+
+                m_order[j] = index;
+            }
+        }
+
+        u32 axis1 = (axis + 1) % 3;
+        u32 axis2 = (axis + 2) % 3;
+
+        //sweep, every box is only tested against the boxes starting before it ends
+        for (u32 i = 0; i < m_order.size(); i++)
+        {
+            const BoundingBox& box1 = boxes[m_order[i]];
+
+            for (u32 j = i + 1; j < m_order.size(); j++)
+            {
+                const BoundingBox& box2 = boxes[m_order[j]];
+
+                if (box2.min[axis] > box1.max[axis])
+                {
+                    break;
+                }
+
+                if (box1.max[axis1] < box2.min[axis1] || box2.max[axis1] < box1.min[axis1] ||
+                    box1.max[axis2] < box2.min[axis2] || box2.max[axis2] < box1.min[axis2])
+                {
+                    continue;
+                }
+
+                m_pairs.push_back({ std::min(m_order[i], m_order[j]), std::max(m_order[i], m_order[j]) });
+            }
+        }
+
+        //every pair is found exactly once, sorting makes the narrowphase access pattern predictable
+        std::sort(m_pairs.begin(), m_pairs.end());
+
+        return m_pairs;
+    }
+
+    /**
+     * choose the axis with the largest variance of the box centers
+     */
+    u32 Broadphase::dominantAxis(const std::vector<BoundingBox>& boxes)
+    {
+        if (boxes.empty())
+        {
+            return 0;
+        }
+
+        glm::vec3 sum(0);
+        glm::vec3 sum_squared(0);
+
+        for (const BoundingBox& box : boxes)
+        {
+            glm::vec3 center = (box.min + box.max) * 0.5f;
+            sum         += center;
+            sum_squared += center * center;
+        }
+
+        glm::vec3 variance = sum_squared / static_cast<float>(boxes.size()) - (sum * sum) / static_cast<float>(boxes.size() * boxes.size());
+
+        if (variance.x >= variance.y && variance.x >= variance.z) { return 0; }
+        if (variance.y >= variance.z)                             { return 1; }
+        return 2;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,84 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Types.hpp"
+#include "SpatialPartition.hpp"
+
+namespace Engine3D
+{
+    /**
+     * scene wide broadphase, finds all pairs of overlapping bounding boxes
+     * using sweep and prune along the axis where the boxes are spread the most
+     */
+    class Broadphase
+    {
+    public:
+
+        /**
+         * candidate pair, indices into the boxes passed to update(), first < second
+         */
+        struct Pair
+        {
+            u32 first;
+            u32 second;
+
+            bool operator==(const Pair& other) const { return first == other.first && second == other.second; }
+            bool operator<(const Pair& other)  const { return first < other.first || (first == other.first && second < other.second); }
+        };
+
+        /**
+         * constructors
+         */
+        Broadphase() {}
+
+        /**
+         * compute overlapping pairs
+         *
+         * \return deduplicated pairs sorted by first and then second index
+         *
+         * \note - the order of the sweep is kept between calls, so boxes that move a little
+         *         every tick are re-sorted almost for free
+         */
+        const std::vector<Pair>& update(const std::vector<BoundingBox>& boxes);
+
+        /**
+         * get the pairs from the last update
+         */
+        const std::vector<Pair>& pairs() const { return m_pairs; }
+
+        /**
+         * get the axis used for the sweep during the last update
+         */
+        u32 sweepAxis() const { return m_axis; }
+
+    private:
+
+        /**
+         * choose the axis with the largest variance of the box centers
+         */
+        static u32 dominantAxis(const std::vector<BoundingBox>& boxes);
+
+        std::vector<u32>  m_order;
+        std::vector<Pair> m_pairs;
+        u32               m_axis { 0 };
+    };
+};
\ No newline at end of file
@@ -17,82 +17,227 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include <unordered_map>
+#include <vector>
+#include <deque>
+#include <list>
+#include <string>
 #include <functional>
 #include <stdexcept>
 #include <cstring>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 #include "Types.hpp"
 #include "File.hpp"
 #include "System.hpp"
+#include "AssetLoader.hpp"
+#include "CacheTelemetry.hpp"
+#include "FileWatcher.hpp"
+#include "AssetManifest.hpp"
 
 namespace Engine3D
 {
+    template<typename T, typename Decoded> class Cache;
+
     /**
-     * std::unordered_map wrapper, that allows load data from file when not present in memory and destroy it when no longer necesary
+     * reference to data of a cache, index of the slot holding the data and the generation of the slot,
+     * the handle gets stale once the data is removed and the slot is reused
      */
     template<typename T>
+    class CacheHandle
+    {
+    public:
+
+        CacheHandle() {}
+
+        /**
+         * check if the handle was returned by a cache
+         */
+        bool valid() const { return m_generation != 0; }
+
+    private:
+
+        template<typename, typename> friend class Cache;
+
+        CacheHandle(u32 index, u32 generation) : m_index(index), m_generation(generation) {}
+
+        u32 m_index      { 0 };
+        u32 m_generation { 0 }; //slots start at generation 1
+    };
+
+    /**
+     * cache of data loaded from files, the data is looked up by path once by get() and by the returned handle afterwards,
+     * the data is destroyed when no longer necesary
+     *
+     * caches with a decoding and an upload function load asynchronously, the file is decoded into Decoded on a worker thread
+     * and the upload turns it into T on the gl thread during AssetLoader::update(), the cache itself is used from the gl thread only
+     *
+     * caches with a size function keep data without references for reuse, the least recently released data is freed
+     * once the loaded data takes more than the budget
+     *
+     * every cache reports its lookups and loads to CacheTelemetry under its name, the named caches also record
+     * the files looked up during the startup into the AssetManifest and prefetch them on the next launch
+     *
+     * files of the loaded data are watched, changed files are reloaded into the same slot so the handles stay valid,
+     * asynchronous caches with a dependency function watch the other files the data was decoded from too
+     */
+    template<typename T, typename Decoded = T>
     class Cache
     {
     public:
-    
+
+        using Handle = CacheHandle<T>;
+
+        /**
+         * default memory budget of the caches in bytes
+         */
+        constexpr static u64 DefaultBudget = 256ull * 1024 * 1024;
+
         /**
          * constructor
+         *
+         * \arg name            - name of the cache in the telemetry
+         * \arg size_function   - bytes taken by the data in ram and on the gpu, measured when it is loaded and when it is released
+         * \arg reload_function - carry state set up on the previous data over to the reloaded one, called before the previous data is cleared
+         * \arg dependency_function - get files besides the loaded one the decoded data was made from, they are watched like the loaded one
          */
-        Cache() {}
-        Cache(std::function<T(File&)> loading_function) : m_loading_function(loading_function) {}
-        Cache(std::function<T(File&)> loading_function, std::function<void(T&)> clear_function) : m_loading_function(loading_function), m_clear_function(clear_function) {} 
+        Cache(const char* name = "") { track(name); }
+        Cache(const char* name, std::function<T(File&)> loading_function) : m_loading_function(loading_function) { track(name); }
+        Cache(const char* name, std::function<T(File&)> loading_function, std::function<void(T&)> clear_function, std::function<u64(const T&)> size_function = {}) :
+            m_loading_function(loading_function), m_clear_function(clear_function), m_size_function(size_function) { track(name); }
+        Cache(const char* name, std::function<Decoded(File&)> decoding_function, std::function<T(Decoded&)> upload_function, std::function<void(T&)> clear_function,
+              std::function<u64(const T&)> size_function = {}, std::function<void(const T&, T&)> reload_function = {},
+              std::function<std::vector<std::string>(const std::string&, const Decoded&)> dependency_function = {}) :
+            m_decoding_function(decoding_function), m_upload_function(upload_function), m_clear_function(clear_function), m_size_function(size_function),
+            m_reload_function(reload_function), m_dependency_function(dependency_function) { track(name); }
+
+        Cache(const Cache&) = delete;
+        Cache& operator=(const Cache&) = delete;
+
+        /**
+         * destructor
+         */
+        ~Cache()
+        {
+            CacheTelemetry::untrack(&m_statistics);
+
+            if (m_statistics.name.empty() == false)
+            {
+                AssetManifest::untrack(m_statistics.name);
+            }
+        }
         
         /**
-         * load data if not present, increase the reference count
-         * and return the pointer to the data
+         * start loading data if not present, increase the reference count
+         * and return the handle of the data, the data of asynchronous caches is ready later
          */
-        const T* get(const std::string&& id) { return get(id.c_str()); }
-        const T* get(const std::string& id)  { return get(id.c_str()); }
-        const T* get(const char* id)
+        Handle get(const std::string&& id) { return get(id.c_str()); }
+        Handle get(const std::string& id)  { return get(id.c_str()); }
+        Handle get(const char* id)
         {
             if (!std::strcmp(id, ""))
             {
-                return nullptr;
+                return Handle();
             }
 
-            auto it = m_implementation.find(id);
+            AssetManifest::touch(m_statistics.name, id);
+
+            auto it = m_ids.find(id);
 
-            // object not in cache
-            if (it == m_implementation.end())
+            // object in cache, data kept for reuse is taken back
+            if (it != m_ids.end())
             {
-                // open input file
-                File input_file(System::getFullPath(id), File::OpenMode::Read);
+                CacheObject& object = m_slots[it->second].object;
+                m_statistics.hits++;
 
-                if (input_file.failed())
+                if (object.ref_counter++ == 0)
                 {
-                    input_file.close();
-                    throw std::runtime_error("Cache::get() cannot open input file");
+                    m_idle.erase(object.idle);
+                    m_statistics.reuses++;
                 }
 
-                // load the object from the file
-                if (m_loading_function)
+                return handle(it->second);
+            }
+
+            // decode on the workers
+            if (m_decoding_function)
+            {
+                u32          index  = allocate(id);
+                CacheObject& object = m_slots[index].object;
+                object.ref_counter  = 1;
+                object.job          = std::make_shared<Job>();
+                object.job->path    = System::getFullPath(id);
+                object.load         = startLoad(id, CacheTelemetry::requester());
+                m_statistics.misses++;
+
+                std::shared_ptr<Job> job = object.job;
+                Handle               key = handle(index);
+
+                AssetLoader::decode([this, job, key]
+                    {
+                        //the gl thread needed the data sooner and decoded it itself
+                        if (decode(*job))
+                        {
+                            AssetLoader::upload([this, job, key] { finish(key, job); });
+                        }
+                    });
+
+                return key;
+            }
+
+            u32  load  = startLoad(id, CacheTelemetry::requester());
+            auto start = std::chrono::steady_clock::now();
+            m_statistics.misses++;
+
+            // open input file
+            File input_file(System::getFullPath(id), File::OpenMode::Read);
+
+            if (input_file.failed())
+            {
+                input_file.close();
+                failLoad(load);
+                throw std::runtime_error("Cache::get() cannot open input file");
+            }
+
+            // load the object from the file
+            if (m_loading_function)
+            {
+                T data;
+
+                try
                 {
-                    m_implementation.insert(std::pair<std::string, CacheObject>(id, { 1, m_loading_function(input_file) }));
-                    input_file.close();
-                    return const_cast<const T*>(&(m_implementation[id].data));
+                    data = m_loading_function(input_file);
                 }
-                else
+                catch (const std::runtime_error&)
                 {
-                    //TODO: error
-                    input_file.close();
-                    throw std::runtime_error("Cache::get() loading function not specified");
+                    failLoad(load);
+                    throw;
                 }
 
-                throw std::runtime_error("Cache::get() this shouldnLt be thrown\n");
+                input_file.close();
 
-                //never reached
-                return nullptr;
+                u32          index  = allocate(id);
+                CacheObject& object = m_slots[index].object;
+                object.ref_counter  = 1;
+                object.data         = std::move(data);
+                object.ready        = true;
+                object.load         = load;
+                measure(object);
+
+                m_statistics.resident++;
+                finishLoad(object, std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count(), 0);
+
+                return handle(index);
             }
-            // object in cache
             else
             {
-                it->second.ref_counter++;
-                return const_cast<const T*>(&it->second.data);
+                //TODO: error
+                input_file.close();
+                failLoad(load);
+                throw std::runtime_error("Cache::get() loading function not specified");
             }
         }
         
@@ -104,28 +249,104 @@ namespace Engine3D
         void add(const char* id)          { get(id); }
         
         /**
-         * lookup data without incrementing the reference count
+         * lookup loaded data without incrementing the reference count, nullptr while it is loading or if the handle is stale
          */
-        const T* peek(const std::string&& id) { return peek(id.c_str()); }
-        const T* peek(const std::string& id)  { return peek(id.c_str()); }
-        const T* peek(const char* id)
+        const T* peek(Handle id) const
         {
-            if (!std::strcmp(id, ""))
+            const CacheObject* object = resolve(id);
+
+            // object not in cache or not loaded
+            if (object == nullptr || object->ready == false)
             {
                 return nullptr;
             }
+            // object in cache
+            else
+            {
+                return &object->data;
+            }
+        }
 
-            auto it = m_implementation.find(id);
+        /**
+         * get data, if it is still loading it is finished on the calling thread, used when the data can't wait
+         * for the next frames
+         */
+        const T* wait(Handle id)
+        {
+            CacheObject* object = resolve(id);
 
-            // object not in cache
-            if (it == m_implementation.end())
+            if (object == nullptr)
             {
                 return nullptr;
             }
-            // object in cache
-            else
+
+            if (object->job)
             {
-                return const_cast<const T*>(&it->second.data);
+                std::shared_ptr<Job> job = object->job;
+
+                //decode here if no worker took the job yet, otherwise wait for the worker
+                decode(*job);
+
+                {
+                    std::unique_lock<std::mutex> lock(job->mutex);
+                    job->finished.wait(lock, [&] { return job->done; });
+                }
+
+                finish(id, job);
+            }
+
+            if (object->ready == false)
+            {
+                throw std::runtime_error("Cache::wait() error: " + object->error);
+            }
+
+            return &object->data;
+        }
+
+        /**
+         * call the function with the data once it is loaded, right away if it already is,
+         * the function is dropped if the loading fails
+         */
+        void whenReady(Handle id, std::function<void(const T&)> callback)
+        {
+            CacheObject* object = resolve(id);
+
+            if (object == nullptr)
+            {
+                return;
+            }
+
+            if (object->ready)
+            {
+                callback(object->data);
+            }
+            else if (object->job)
+            {
+                object->ready_callbacks.push_back(std::move(callback));
+            }
+        }
+
+        /**
+         * change the data once it is loaded, right away if it already is, the function is dropped if the loading fails,
+         * every handle of the data sees the change and its bytes are measured again
+         */
+        void modify(Handle id, std::function<void(T&)> callback)
+        {
+            CacheObject* object = resolve(id);
+
+            if (object == nullptr)
+            {
+                return;
+            }
+
+            if (object->ready)
+            {
+                callback(object->data);
+                measure(*object);
+            }
+            else if (object->job)
+            {
+                object->ready_callbacks.push_back([this, id, callback = std::move(callback)](const T&) { modify(id, callback); });
             }
         }
         
@@ -136,47 +357,563 @@ namespace Engine3D
         void del(const std::string& id)  { return del(id.c_str()); }
         void del(const char* id)
         {
-            if (!std::strcmp(id, ""))
+            auto it = m_ids.find(id);
+
+            if (it != m_ids.end())
+            {
+                del(handle(it->second));
+            }
+        }
+        void del(Handle id)
+        {
+            CacheObject* object = resolve(id);
+
+            if (object == nullptr || object->ref_counter == 0)
             {
                 return;
             }
 
-            auto it = m_implementation.find(id);
+            if (--object->ref_counter == 0)
+            {
+                //data still decoding is dropped once the worker finishes it
+                if (m_size_function && object->ready)
+                {
+                    measure(*object);
+
+                    m_idle.push_front(id.m_index);
+                    object->idle = m_idle.begin();
 
-            if (it == m_implementation.end())
+                    trim();
+                }
+                else
+                {
+                    release(id.m_index);
+                }
+            }
+        }
+
+        /**
+         * load the file of the data again, the handle keeps pointing to the data, the previous data is used until the new one
+         * is ready and kept if the loading fails, data without references is freed instead, called when the file changes
+         */
+        void reload(Handle id)
+        {
+            CacheObject* object = resolve(id);
+
+            if (object == nullptr || (!m_decoding_function && !m_loading_function))
             {
                 return;
             }
-            else
+
+            if (object->ref_counter == 0)
             {
-                if (--it->second.ref_counter == 0)
-                {
-                    if (m_clear_function)
+                m_idle.erase(object->idle);
+                release(id.m_index);
+                return;
+            }
+
+            std::printf("Cache::reload() log: %s\n", object->id.c_str());
+            m_statistics.reloads++;
+
+            // decode on the workers, a reload still in progress is dropped
+            if (m_decoding_function)
+            {
+                object->job       = std::make_shared<Job>();
+                object->job->path = System::getFullPath(object->id);
+                object->load      = startLoad(object->id.c_str(), "reload");
+
+                std::shared_ptr<Job> job = object->job;
+
+                AssetLoader::decode([this, job, id]
                     {
-                        m_clear_function(it->second.data);
-                    }
+                        if (decode(*job))
+                        {
+                            AssetLoader::upload([this, job, id] { finish(id, job); });
+                        }
+                    });
+
+                return;
+            }
 
-                    m_implementation.erase(it);
+            object->load = startLoad(object->id.c_str(), "reload");
+            auto start   = std::chrono::steady_clock::now();
+
+            try
+            {
+                File input_file(System::getFullPath(object->id), File::OpenMode::Read);
+
+                if (input_file.failed())
+                {
+                    throw std::runtime_error("Cache::reload() cannot open input file");
                 }
+
+                T data = m_loading_function(input_file);
+                input_file.close();
+
+                replace(*object, std::move(data));
+                finishLoad(*object, std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count(), 0);
+            }
+            catch (const std::runtime_error& error)
+            {
+                std::printf("Cache::reload() error: %s - %s\n", error.what(), object->id.c_str());
+                failLoad(object->load);
             }
         }
+
+        /**
+         * get number of times the data was reloaded, used to set up state that depends on the data again
+         */
+        u32 version(Handle id) const
+        {
+            const CacheObject* object = resolve(id);
+
+            return object != nullptr ? object->version : 0;
+        }
+
+        /**
+         * set memory budget in bytes, data without references is freed until the cache fits into it
+         */
+        void setBudget(u64 budget)
+        {
+            m_budget = budget;
+            trim();
+        }
+
+        /**
+         * get memory budget in bytes
+         */
+        u64 budget() const { return m_budget; }
+
+        /**
+         * get bytes taken by the loaded data, including the data kept for reuse
+         */
+        u64 bytes() const { return m_statistics.bytes; }
+
+        /**
+         * get lookup and load statistics
+         */
+        const CacheTelemetry::Statistics& statistics() const { return m_statistics; }
     
     private:
+
+        /**
+         * decoding of one file, shared by the worker, the upload queue and the cache
+         */
+        struct Job
+        {
+            std::string             path;
+            Decoded                 decoded {};
+            std::string             error;
+
+            std::mutex              mutex;
+            std::condition_variable finished;
+            bool                    started { false };
+            bool                    done    { false };
+            float                   decode_time { 0 };
+        };
     
         /**
          * keep track of references to the same object
          */
         struct CacheObject
         {
-            u32 ref_counter;
-            T   data;
+            std::string          id; //path the data was loaded from
+            u32                  ref_counter { 0 };
+            T                    data        {};
+            bool                 ready       { false };
+            std::string          error;
+            std::shared_ptr<Job> job; //decoding in progress
+            std::vector<std::function<void(const T&)>> ready_callbacks;
+            u64                  bytes       { 0 };
+            u32                  load        { 0 }; //index of the load in the statistics
+            u32                  watch       { 0 }; //watch of the file
+            std::vector<u32>     dependency_watches; //watches of the files returned by the dependency function
+            u32                  version     { 0 }; //number of reloads
+            std::list<u32>::iterator idle; //position in the reuse list while there are no references
         };
+
+        /**
+         * slot of the data array, the generation changes every time the slot is freed
+         */
+        struct Slot
+        {
+            CacheObject object;
+            u32         generation { 1 };
+            bool        used       { false };
+        };
+
+        /**
+         * register the statistics and the prefetching under the name
+         */
+        void track(const char* name)
+        {
+            m_statistics.name = name;
+            CacheTelemetry::track(&m_statistics);
+
+            if (m_statistics.name.empty() == false)
+            {
+                AssetManifest::track(name, [this](const std::string& path) -> std::function<void()>
+                    {
+                        Handle id = get(path);
+                        return [this, id] { del(id); };
+                    });
+            }
+        }
+
+        /**
+         * record load of the path, return index of the record
+         */
+        u32 startLoad(const char* id, const char* requester)
+        {
+            CacheTelemetry::LoadRecord record;
+            record.path         = id;
+            record.requester    = requester;
+            record.requested_at = CacheTelemetry::now();
+
+            m_statistics.loads.push_back(std::move(record));
+
+            return static_cast<u32>(m_statistics.loads.size() - 1);
+        }
+
+        /**
+         * record times and size of the loaded data
+         */
+        void finishLoad(const CacheObject& object, float decode_time, float upload_time)
+        {
+            CacheTelemetry::LoadRecord& record = m_statistics.loads[object.load];
+            record.decode_time = decode_time;
+            record.upload_time = upload_time;
+            record.latency     = CacheTelemetry::now() - record.requested_at;
+            record.bytes       = object.bytes;
+
+            CacheTelemetry::addLoadTime(m_statistics, decode_time + upload_time);
+        }
+
+        /**
+         * record failed load
+         */
+        void failLoad(u32 load)
+        {
+            m_statistics.loads[load].failed  = true;
+            m_statistics.loads[load].latency = CacheTelemetry::now() - m_statistics.loads[load].requested_at;
+            m_statistics.failures++;
+        }
+
+        /**
+         * take a free slot for the data loaded from the path
+         */
+        u32 allocate(const char* id)
+        {
+            u32 index;
+
+            if (m_free.empty())
+            {
+                index = static_cast<u32>(m_slots.size());
+                m_slots.emplace_back();
+            }
+            else
+            {
+                index = m_free.back();
+                m_free.pop_back();
+            }
+
+            m_slots[index].used      = true;
+            m_slots[index].object.id = id;
+            m_ids[id]                = index;
+
+            Handle key = handle(index);
+            m_slots[index].object.watch = FileWatcher::watch(System::getFullPath(id), [this, key] { reload(key); });
+
+            return index;
+        }
+
+        /**
+         * swap reloaded data in, the previous data is cleared
+         */
+        void replace(CacheObject& object, T&& data)
+        {
+            if (m_reload_function)
+            {
+                m_reload_function(object.data, data);
+            }
+
+            if (m_clear_function)
+            {
+                m_clear_function(object.data);
+            }
+
+            object.data = std::move(data);
+            object.version++;
+            measure(object);
+        }
+
+        /**
+         * get handle of the data in the slot
+         */
+        Handle handle(u32 index) const { return Handle(index, m_slots[index].generation); }
+
+        /**
+         * get data the handle refers to, nullptr if the handle is stale
+         */
+        CacheObject* resolve(Handle id)
+        {
+            return const_cast<CacheObject*>(static_cast<const Cache*>(this)->resolve(id));
+        }
+        const CacheObject* resolve(Handle id) const
+        {
+            if (id.m_index >= m_slots.size() || m_slots[id.m_index].generation != id.m_generation || m_slots[id.m_index].used == false)
+            {
+                return nullptr;
+            }
+
+            return &m_slots[id.m_index].object;
+        }
+
+        /**
+         * update the bytes taken by the data
+         */
+        void measure(CacheObject& object)
+        {
+            if (m_size_function)
+            {
+                m_statistics.bytes -= object.bytes;
+                object.bytes        = m_size_function(object.data);
+                m_statistics.bytes += object.bytes;
+            }
+        }
+
+        /**
+         * free the data and the slot holding it
+         */
+        void release(u32 index)
+        {
+            Slot& slot = m_slots[index];
+
+            if (m_clear_function && slot.object.ready)
+            {
+                m_clear_function(slot.object.data);
+            }
+
+            if (slot.object.ready)
+            {
+                m_statistics.resident--;
+            }
+
+            m_statistics.bytes -= slot.object.bytes;
+            forget(index);
+
+            //handles of the data get stale, generation 0 is kept for handles not returned by a cache
+            slot.object = CacheObject();
+            slot.used   = false;
+
+            if (++slot.generation == 0)
+            {
+                slot.generation = 1;
+            }
+
+            m_free.push_back(index);
+        }
+
+        /**
+         * stop finding the data in the slot by its path and stop watching the file
+         */
+        void forget(u32 index)
+        {
+            CacheObject& object = m_slots[index].object;
+            auto         it     = m_ids.find(object.id);
+
+            //the path may already belong to a newer load
+            if (it != m_ids.end() && it->second == index)
+            {
+                m_ids.erase(it);
+            }
+
+            FileWatcher::unwatch(object.watch);
+            object.watch = 0;
+
+            for (u32 watch : object.dependency_watches)
+            {
+                FileWatcher::unwatch(watch);
+            }
+
+            object.dependency_watches.clear();
+        }
+
+        /**
+         * watch the files the data was decoded from besides its own, the previous watches are replaced
+         */
+        void watchDependencies(Handle id, const std::vector<std::string>& dependencies)
+        {
+            CacheObject& object = m_slots[id.m_index].object;
+
+            for (u32 watch : object.dependency_watches)
+            {
+                FileWatcher::unwatch(watch);
+            }
+
+            object.dependency_watches.clear();
+
+            for (auto& dependency : dependencies)
+            {
+                object.dependency_watches.push_back(FileWatcher::watch(dependency, [this, id] { reload(id); }));
+            }
+        }
+
+        /**
+         * free the least recently released data until the cache fits into the budget
+         */
+        void trim()
+        {
+            while (m_statistics.bytes > m_budget && m_idle.empty() == false)
+            {
+                u32 index = m_idle.back();
+                m_idle.pop_back();
+                m_statistics.evictions++;
+
+                release(index);
+            }
+        }
+
+        /**
+         * decode the file of the job unless another thread took it, return false if it did
+         */
+        bool decode(Job& job)
+        {
+            {
+                std::lock_guard<std::mutex> lock(job.mutex);
+
+                if (job.started)
+                {
+                    return false;
+                }
+
+                job.started = true;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+
+            try
+            {
+                File input_file(job.path, File::OpenMode::Read);
+
+                if (input_file.failed())
+                {
+                    throw std::runtime_error("Cache::get() cannot open input file");
+                }
+
+                job.decoded = m_decoding_function(input_file);
+            }
+            catch (const std::runtime_error& error)
+            {
+                job.error = error.what();
+            }
+
+            job.decode_time = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+            {
+                std::lock_guard<std::mutex> lock(job.mutex);
+                job.done = true;
+            }
+
+            job.finished.notify_all();
+            return true;
+        }
+
+        /**
+         * upload decoded data on the gl thread, data deleted or reloaded in the meantime is dropped
+         */
+        void finish(Handle id, const std::shared_ptr<Job>& job)
+        {
+            CacheObject* found = resolve(id);
+
+            if (found == nullptr || found->job != job)
+            {
+                return;
+            }
+
+            CacheObject& object = *found;
+            object.job.reset();
+
+            auto start = std::chrono::steady_clock::now();
+
+            if (job->error.empty())
+            {
+                try
+                {
+                    //the upload may take the decoded data apart
+                    std::vector<std::string> dependencies = m_dependency_function ? m_dependency_function(job->path, job->decoded) : std::vector<std::string>();
+
+                    T data = m_upload_function(job->decoded);
+
+                    if (object.ready)
+                    {
+                        replace(object, std::move(data));
+                    }
+                    else
+                    {
+                        object.data  = std::move(data);
+                        object.ready = true;
+                        measure(object);
+                        m_statistics.resident++;
+                    }
+
+                    watchDependencies(id, dependencies);
+                    finishLoad(object, job->decode_time, std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count());
+                }
+                catch (const std::runtime_error& error)
+                {
+                    job->error = error.what();
+                }
+            }
+
+            if (job->error.empty() == false)
+            {
+                failLoad(object.load);
+            }
+
+            //failed reload keeps the previous data
+            if (object.ready == false)
+            {
+                object.error = job->error;
+                object.ready_callbacks.clear();
+                std::printf("Cache::get() error: %s - %s\n", object.error.c_str(), object.id.c_str());
+
+                //handles of the failed load keep reporting the error, the next get() of the path loads it again
+                forget(id.m_index);
+                return;
+            }
+            else if (job->error.empty() == false)
+            {
+                std::printf("Cache::reload() error: %s - %s\n", job->error.c_str(), object.id.c_str());
+            }
+
+            auto callbacks = std::move(object.ready_callbacks);
+
+            for (auto& callback : callbacks)
+            {
+                callback(object.data);
+            }
+
+            trim();
+        }
     
         /**
          * cache implementation
          */
-        std::unordered_map<std::string, CacheObject> m_implementation;
-        std::function<T(File&)>              m_loading_function;
+        std::deque<Slot>                             m_slots; //deque keeps the data in place when slots are added
+        std::vector<u32>                             m_free;
+        std::unordered_map<std::string, u32>         m_ids;
+        std::function<T(File&)>                      m_loading_function;
+        std::function<Decoded(File&)>                m_decoding_function;
+        std::function<T(Decoded&)>                   m_upload_function;
         std::function<void(T&)>                      m_clear_function;
+        std::function<u64(const T&)>                 m_size_function;
+        std::function<void(const T&, T&)>            m_reload_function;
+        std::function<std::vector<std::string>(const std::string&, const Decoded&)> m_dependency_function;
+
+        std::list<u32>                               m_idle; //data without references, the most recently released first
+        u64                                          m_budget { DefaultBudget };
+
+        CacheTelemetry::Statistics                   m_statistics;
     };
-};
+};
\ No newline at end of file
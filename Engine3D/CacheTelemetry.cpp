@@ -0,0 +1,216 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "CacheTelemetry.hpp"
+
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+
+#include "File.hpp"
+#include "System.hpp"
+
+namespace Engine3D
+{
+    namespace
+    {
+        /**
+         * the registry is created by the first cache, so it outlives the caches no matter in which order
+         * the static objects are constructed
+         */
+        std::vector<const CacheTelemetry::Statistics*>& registry()
+        {
+            static std::vector<const CacheTelemetry::Statistics*> caches;
+            return caches;
+        }
+
+        std::vector<const char*>& requesters()
+        {
+            static std::vector<const char*> names;
+            return names;
+        }
+
+        const auto  g_start = std::chrono::steady_clock::now();
+        std::string g_dump_path;
+
+        /**
+         * quote string for json
+         */
+        std::string quote(const std::string& text)
+        {
+            std::string result = "\"";
+
+            for (char c : text)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    result += '\\';
+                }
+
+                result += c;
+            }
+
+            return result + "\"";
+        }
+    }
+
+    /**
+     * requester scope
+     */
+    CacheTelemetry::Requester::Requester(const char* name)
+    {
+        requesters().push_back(name);
+    }
+
+    CacheTelemetry::Requester::~Requester()
+    {
+        requesters().pop_back();
+    }
+
+    /**
+     * get name of the innermost requester
+     */
+    const char* CacheTelemetry::requester()
+    {
+        return requesters().empty() ? "unknown" : requesters().back();
+    }
+
+    /**
+     * get seconds since the start
+     */
+    float CacheTelemetry::now()
+    {
+        return std::chrono::duration<float>(std::chrono::steady_clock::now() - g_start).count();
+    }
+
+    /**
+     * add load time into the histogram
+     */
+    void CacheTelemetry::addLoadTime(Statistics& statistics, float seconds)
+    {
+        float limit  = 0.001f;
+        u32   bucket = 0;
+
+        while (bucket < HistogramBuckets - 1 && seconds >= limit)
+        {
+            limit *= 2;
+            bucket++;
+        }
+
+        statistics.load_times[bucket]++;
+    }
+
+    /**
+     * register statistics of a cache
+     */
+    void CacheTelemetry::track(const Statistics* statistics)
+    {
+        registry().push_back(statistics);
+    }
+
+    void CacheTelemetry::untrack(const Statistics* statistics)
+    {
+        auto& caches = registry();
+        caches.erase(std::remove(caches.begin(), caches.end(), statistics), caches.end());
+    }
+
+    /**
+     * get statistics of every cache
+     */
+    const std::vector<const CacheTelemetry::Statistics*>& CacheTelemetry::caches()
+    {
+        return registry();
+    }
+
+    /**
+     * write statistics of every cache as json
+     */
+    void CacheTelemetry::dump(const std::string& path)
+    {
+        File output(System::getFullPath(path), File::OpenMode::Write);
+
+        if (output.failed())
+        {
+            throw std::runtime_error("CacheTelemetry::dump() error: cannot open output file");
+        }
+
+        output.write("{\"caches\":[");
+
+        for (u64 i = 0; i < registry().size(); i++)
+        {
+            const Statistics& statistics = *registry()[i];
+
+            output.write(std::string(i > 0 ? "," : "") + "{\"name\":" + quote(statistics.name) +
+                         ",\"hits\":"      + std::to_string(statistics.hits) +
+                         ",\"reuses\":"    + std::to_string(statistics.reuses) +
+                         ",\"misses\":"    + std::to_string(statistics.misses) +
+                         ",\"reloads\":"   + std::to_string(statistics.reloads) +
+                         ",\"failures\":"  + std::to_string(statistics.failures) +
+                         ",\"evictions\":" + std::to_string(statistics.evictions) +
+                         ",\"resident\":"  + std::to_string(statistics.resident) +
+                         ",\"bytes\":"     + std::to_string(statistics.bytes) +
+                         ",\"load_times_ms\":{");
+
+            //buckets are named by their upper limit
+            for (u32 bucket = 0; bucket < HistogramBuckets; bucket++)
+            {
+                std::string limit = bucket < HistogramBuckets - 1 ? "<" + std::to_string(1u << bucket) : ">=" + std::to_string(1u << (bucket - 1));
+
+                output.write(std::string(bucket > 0 ? "," : "") + quote(limit) + ":" + std::to_string(statistics.load_times[bucket]));
+            }
+
+            output.write("},\"loads\":[");
+
+            for (u64 j = 0; j < statistics.loads.size(); j++)
+            {
+                const LoadRecord& load = statistics.loads[j];
+
+                output.write(std::string(j > 0 ? "," : "") + "{\"path\":" + quote(load.path) +
+                             ",\"requester\":"    + quote(load.requester) +
+                             ",\"requested_at\":" + std::to_string(load.requested_at) +
+                             ",\"decode_time\":"  + std::to_string(load.decode_time) +
+                             ",\"upload_time\":"  + std::to_string(load.upload_time) +
+                             ",\"latency\":"      + std::to_string(load.latency) +
+                             ",\"bytes\":"        + std::to_string(load.bytes) +
+                             ",\"failed\":"       + (load.failed ? "true" : "false") + "}");
+            }
+
+            output.write("]}");
+        }
+
+        output.write("]}");
+        output.close();
+    }
+
+    /**
+     * set file dump() writes into when the game exits
+     */
+    void CacheTelemetry::setDumpPath(const std::string& path)
+    {
+        g_dump_path = path;
+    }
+
+    /**
+     * write statistics into the file set by setDumpPath()
+     */
+    void CacheTelemetry::dump()
+    {
+        if (g_dump_path.empty() == false)
+        {
+            dump(g_dump_path);
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,126 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Types.hpp"
+
+namespace Engine3D
+{
+    /**
+     * statistics of the caches, every cache reports its lookups and loads here so the costly assets can be found
+     * at runtime and in the file written when the game exits, used from the gl thread only
+     */
+    namespace CacheTelemetry
+    {
+        /**
+         * bucket i of the load time histogram counts loads shorter than 2^i ms, the last one counts the longer ones
+         */
+        constexpr u32 HistogramBuckets = 12;
+
+        /**
+         * one load of a file
+         */
+        struct LoadRecord
+        {
+            std::string path;
+            std::string requester;              //scope that asked for the file, see Requester, "reload" for changed files
+            float       requested_at { 0 };     //seconds since the start
+            float       decode_time  { 0 };     //seconds spent reading and decoding the file
+            float       upload_time  { 0 };     //seconds spent on the gl thread turning the decoded file into the data
+            float       latency      { 0 };     //seconds from the request until the data was ready
+            u64         bytes        { 0 };
+            bool        failed       { false };
+        };
+
+        /**
+         * counters of one cache
+         */
+        struct Statistics
+        {
+            std::string             name;
+            u64                     hits      { 0 }; //lookups of data already in the cache
+            u64                     reuses    { 0 }; //hits of data kept without references
+            u64                     misses    { 0 }; //lookups that started a load
+            u64                     reloads   { 0 }; //loads of changed files
+            u64                     failures  { 0 };
+            u64                     evictions { 0 }; //data kept for reuse freed to fit into the budget
+            u32                     resident  { 0 }; //loaded data
+            u64                     bytes     { 0 }; //bytes of the loaded data, counted by caches with a size function
+            u32                     load_times[HistogramBuckets] {};
+            std::vector<LoadRecord> loads;
+        };
+
+        /**
+         * name data requested while the object lives, the loads started meanwhile are recorded as requested by it,
+         * requesters nest and the innermost one is used
+         */
+        class Requester
+        {
+        public:
+
+            Requester(const char* name);
+            ~Requester();
+
+            Requester(const Requester&) = delete;
+            Requester& operator=(const Requester&) = delete;
+        };
+
+        /**
+         * get name of the innermost requester, "unknown" if there is none
+         */
+        const char* requester();
+
+        /**
+         * get seconds since the start
+         */
+        float now();
+
+        /**
+         * add load time into the histogram
+         */
+        void addLoadTime(Statistics& statistics, float seconds);
+
+        /**
+         * register statistics of a cache, done by the cache itself
+         */
+        void track(const Statistics* statistics);
+        void untrack(const Statistics* statistics);
+
+        /**
+         * get statistics of every cache
+         */
+        const std::vector<const Statistics*>& caches();
+
+        /**
+         * write statistics of every cache as json
+         */
+        void dump(const std::string& path);
+
+        /**
+         * set file dump() writes into when the game exits, nothing is written while the path is empty
+         */
+        void setDumpPath(const std::string& path);
+
+        /**
+         * write statistics into the file set by setDumpPath()
+         */
+        void dump();
+    };
+};
\ No newline at end of file
@@ -17,7 +17,15 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 #include "Collision.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <cmath>
+#include <limits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
 
 #include <glm/gtx/vector_angle.hpp>
 #include <glm/gtx/transform.hpp>
@@ -942,6 +950,185 @@ namespace Engine3D
             return EllipsoidVsTriangle(ellipsoid.pos, ellipsoid.dims, triangle.p1, triangle.p2, triangle.p3);
         }
 
+        /**
+         * squared distance limit of the block culling in the space where the ellipsoid is a unit ball,
+         * slightly above 1 so rounding never rejects a triangle the exact test would accept
+         */
+        static constexpr float BlockCullLimit = 1.01f;
+
+        /**
+         * find triangles of the block the ellipsoid may collide with
+         *
+         * EllipsoidVsTriangle reports a collision only if the distance between the ball and the triangle
+         * plane, an edge or a corner is below 1, all of them are at least the distance to the triangle,
+         * so triangles whose box or plane is further than 1 can be skipped
+         */
+        u32 EllipsoidVsTriangleBlockCandidates(const glm::vec3& pos, const glm::vec3& dims, const TriangleBlock& block)
+        {
+            glm::vec3 inv_dims = 1.0f / dims;
+            u32       mask     = 0;
+
+#if defined(__AVX__)
+            __m256 pos_x  = _mm256_set1_ps(pos.x);
+            __m256 pos_y  = _mm256_set1_ps(pos.y);
+            __m256 pos_z  = _mm256_set1_ps(pos.z);
+            __m256 inv_x  = _mm256_set1_ps(inv_dims.x);
+            __m256 inv_y  = _mm256_set1_ps(inv_dims.y);
+            __m256 inv_z  = _mm256_set1_ps(inv_dims.z);
+            __m256 zero   = _mm256_setzero_ps();
+            __m256 limit  = _mm256_set1_ps(BlockCullLimit);
+
+            //move the points into the space of the unit ball
+            __m256 ax = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(block.x[0]), pos_x), inv_x);
+            __m256 ay = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(block.y[0]), pos_y), inv_y);
+            __m256 az = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(block.z[0]), pos_z), inv_z);
+            __m256 bx = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(block.x[1]), pos_x), inv_x);
+            __m256 by = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(block.y[1]), pos_y), inv_y);
+            __m256 bz = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(block.z[1]), pos_z), inv_z);
+            __m256 cx = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(block.x[2]), pos_x), inv_x);
+            __m256 cy = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(block.y[2]), pos_y), inv_y);
+            __m256 cz = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(block.z[2]), pos_z), inv_z);
+
+            //distance between the center and the triangle box
+            __m256 dx = _mm256_add_ps(_mm256_max_ps(_mm256_min_ps(ax, _mm256_min_ps(bx, cx)), zero),
+                                      _mm256_max_ps(_mm256_sub_ps(zero, _mm256_max_ps(ax, _mm256_max_ps(bx, cx))), zero));
+            __m256 dy = _mm256_add_ps(_mm256_max_ps(_mm256_min_ps(ay, _mm256_min_ps(by, cy)), zero),
+                                      _mm256_max_ps(_mm256_sub_ps(zero, _mm256_max_ps(ay, _mm256_max_ps(by, cy))), zero));
+            __m256 dz = _mm256_add_ps(_mm256_max_ps(_mm256_min_ps(az, _mm256_min_ps(bz, cz)), zero),
+                                      _mm256_max_ps(_mm256_sub_ps(zero, _mm256_max_ps(az, _mm256_max_ps(bz, cz))), zero));
+
+            __m256 box_distance = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_add_ps(_mm256_mul_ps(dy, dy), _mm256_mul_ps(dz, dz)));
+
+            //distance between the center and the triangle plane, compared without the square root
+            __m256 e1x = _mm256_sub_ps(bx, ax), e1y = _mm256_sub_ps(by, ay), e1z = _mm256_sub_ps(bz, az);
+            __m256 e2x = _mm256_sub_ps(cx, ax), e2y = _mm256_sub_ps(cy, ay), e2z = _mm256_sub_ps(cz, az);
+
+            __m256 nx = _mm256_sub_ps(_mm256_mul_ps(e1y, e2z), _mm256_mul_ps(e1z, e2y));
+            __m256 ny = _mm256_sub_ps(_mm256_mul_ps(e1z, e2x), _mm256_mul_ps(e1x, e2z));
+            __m256 nz = _mm256_sub_ps(_mm256_mul_ps(e1x, e2y), _mm256_mul_ps(e1y, e2x));
+
+            __m256 plane  = _mm256_add_ps(_mm256_mul_ps(nx, ax), _mm256_add_ps(_mm256_mul_ps(ny, ay), _mm256_mul_ps(nz, az)));
+            __m256 length = _mm256_add_ps(_mm256_mul_ps(nx, nx), _mm256_add_ps(_mm256_mul_ps(ny, ny), _mm256_mul_ps(nz, nz)));
+
+            __m256 near_box   = _mm256_cmp_ps(box_distance, limit, _CMP_LE_OQ);
+            __m256 far_plane  = _mm256_cmp_ps(_mm256_mul_ps(plane, plane), _mm256_mul_ps(limit, length), _CMP_GT_OQ);
+
+            mask = static_cast<u32>(_mm256_movemask_ps(_mm256_andnot_ps(far_plane, near_box)));
+#elif defined(__SSE2__) || defined(_M_X64)
+            __m128 pos_x  = _mm_set1_ps(pos.x);
+            __m128 pos_y  = _mm_set1_ps(pos.y);
+            __m128 pos_z  = _mm_set1_ps(pos.z);
+            __m128 inv_x  = _mm_set1_ps(inv_dims.x);
+            __m128 inv_y  = _mm_set1_ps(inv_dims.y);
+            __m128 inv_z  = _mm_set1_ps(inv_dims.z);
+            __m128 zero   = _mm_setzero_ps();
+            __m128 limit  = _mm_set1_ps(BlockCullLimit);
+
+            //two halves of the block, 4 triangles each
+            for (u32 half = 0; half < TriangleBlock::Width; half += 4)
+            {
+                //move the points into the space of the unit ball
+                __m128 ax = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(block.x[0] + half), pos_x), inv_x);
+                __m128 ay = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(block.y[0] + half), pos_y), inv_y);
+                __m128 az = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(block.z[0] + half), pos_z), inv_z);
+                __m128 bx = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(block.x[1] + half), pos_x), inv_x);
+                __m128 by = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(block.y[1] + half), pos_y), inv_y);
+                __m128 bz = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(block.z[1] + half), pos_z), inv_z);
+                __m128 cx = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(block.x[2] + half), pos_x), inv_x);
+                __m128 cy = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(block.y[2] + half), pos_y), inv_y);
+                __m128 cz = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(block.z[2] + half), pos_z), inv_z);
+
+                //distance between the center and the triangle box
+                __m128 dx = _mm_add_ps(_mm_max_ps(_mm_min_ps(ax, _mm_min_ps(bx, cx)), zero),
+                                       _mm_max_ps(_mm_sub_ps(zero, _mm_max_ps(ax, _mm_max_ps(bx, cx))), zero));
+                __m128 dy = _mm_add_ps(_mm_max_ps(_mm_min_ps(ay, _mm_min_ps(by, cy)), zero),
+                                       _mm_max_ps(_mm_sub_ps(zero, _mm_max_ps(ay, _mm_max_ps(by, cy))), zero));
+                __m128 dz = _mm_add_ps(_mm_max_ps(_mm_min_ps(az, _mm_min_ps(bz, cz)), zero),
+                                       _mm_max_ps(_mm_sub_ps(zero, _mm_max_ps(az, _mm_max_ps(bz, cz))), zero));
+
+                __m128 box_distance = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_add_ps(_mm_mul_ps(dy, dy), _mm_mul_ps(dz, dz)));
+
+                //distance between the center and the triangle plane, compared without the square root
+                __m128 e1x = _mm_sub_ps(bx, ax), e1y = _mm_sub_ps(by, ay), e1z = _mm_sub_ps(bz, az);
+                __m128 e2x = _mm_sub_ps(cx, ax), e2y = _mm_sub_ps(cy, ay), e2z = _mm_sub_ps(cz, az);
+
+                __m128 nx = _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e1z, e2y));
+                __m128 ny = _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e1x, e2z));
+                __m128 nz = _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e1y, e2x));
+
+                __m128 plane  = _mm_add_ps(_mm_mul_ps(nx, ax), _mm_add_ps(_mm_mul_ps(ny, ay), _mm_mul_ps(nz, az)));
+                __m128 length = _mm_add_ps(_mm_mul_ps(nx, nx), _mm_add_ps(_mm_mul_ps(ny, ny), _mm_mul_ps(nz, nz)));
+
+                __m128 near_box  = _mm_cmple_ps(box_distance, limit);
+                __m128 far_plane = _mm_cmpgt_ps(_mm_mul_ps(plane, plane), _mm_mul_ps(limit, length));
+
+                mask |= static_cast<u32>(_mm_movemask_ps(_mm_andnot_ps(far_plane, near_box))) << half;
+            }
+#else
+            for (u32 i = 0; i < TriangleBlock::Width; i++)
+            {
+                //move the points into the space of the unit ball
+                glm::vec3 a = (glm::vec3(block.x[0][i], block.y[0][i], block.z[0][i]) - pos) * inv_dims;
+                glm::vec3 b = (glm::vec3(block.x[1][i], block.y[1][i], block.z[1][i]) - pos) * inv_dims;
+                glm::vec3 c = (glm::vec3(block.x[2][i], block.y[2][i], block.z[2][i]) - pos) * inv_dims;
+
+                //distance between the center and the triangle box
+                glm::vec3 d = glm::max(glm::min(a, glm::min(b, c)), glm::vec3(0)) +
+                              glm::max(-glm::max(a, glm::max(b, c)), glm::vec3(0));
+
+                bool near_box = glm::dot(d, d) <= BlockCullLimit;
+
+                //distance between the center and the triangle plane, compared without the square root
+                glm::vec3 normal = glm::cross(b - a, c - a);
+                float     plane  = glm::dot(normal, a);
+
+                bool far_plane = plane * plane > BlockCullLimit * glm::dot(normal, normal);
+
+                if (near_box && !far_plane)
+                {
+                    mask |= 1u << i;
+                }
+            }
+#endif
+
+            //lanes past the count hold garbage
+            return mask & ((1u << block.count) - 1u);
+        }
+
+        /**
+         * ellipsoid vs block of triangles
+         */
+        Data EllipsoidVsTriangleBlock(glm::vec3& pos, const glm::vec3& dims, const TriangleBlock& block)
+        {
+            Data res;
+
+            u32 mask = EllipsoidVsTriangleBlockCandidates(pos, dims, block);
+
+            while (mask != 0)
+            {
+                u32 i = static_cast<u32>(std::countr_zero(mask));
+
+                Triangle triangle  = block.get(i);
+                Data     collision = EllipsoidVsTriangle(pos, dims, triangle.p1, triangle.p2, triangle.p3);
+
+                if (collision.occurred)
+                {
+                    pos              += collision.displacement;
+                    res.occurred      = true;
+                    res.displacement += collision.displacement;
+
+                    //the ellipsoid moved, so the remaining triangles have to be culled again
+                    mask = EllipsoidVsTriangleBlockCandidates(pos, dims, block) & ~((2u << i) - 1u);
+                }
+                else
+                {
+                    mask &= mask - 1;
+                }
+            }
+
+            return res;
+        }
+
         /**
          * sweep ellipsoid vs triangle
          *
@@ -1345,182 +1532,597 @@ namespace Engine3D
         }
         
         /**
-         * mesh vs mesh using separating axes theorem algorithm
+         * simplex of the minkowski difference used by GJK, the newest point is the first one
          */
-        Data MeshVsMeshSeparatingAxesTheorem(SceneObject* m1, SceneObject* m2)
+        struct Simplex
         {
-            Data res;
+            glm::vec3 points[4];
+            u32       size { 0 };
 
-            //variables for calculation of minimal translation vector
-            float min_overlap = std::numeric_limits<float>::max();
-            glm::vec3 min_trans_vec = glm::vec3(0);
+            void push(const glm::vec3& point)
+            {
+                points[3] = points[2];
+                points[2] = points[1];
+                points[1] = points[0];
+                points[0] = point;
+                size      = std::min(size + 1, 4u);
+            }
 
-            glm::vec3 delta = m2->pos() - m1->pos();
+            void set(const glm::vec3& a)                                                       { points[0] = a; size = 1; }
+            void set(const glm::vec3& a, const glm::vec3& b)                                   { points[0] = a; points[1] = b; size = 2; }
+            void set(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)               { points[0] = a; points[1] = b; points[2] = c; size = 3; }
+        };
 
-            //extract vertices
-            const std::vector<Vertex>& m1_vertices = *m1->vertices();
-            const std::vector<Vertex>& m2_vertices = *m2->vertices();
+        static bool sameDirection(const glm::vec3& a, const glm::vec3& b)
+        {
+            return glm::dot(a, b) > 0.0f;
+        }
 
-            //for every triangle in mesh 1
-            for(u32 i = 0; i < m1_vertices.size(); i += 3)
+        /**
+         * any vector perpendicular to the vector
+         */
+        static glm::vec3 perpendicular(const glm::vec3& v)
+        {
+            return std::fabs(v.x) < 0.57735f ? glm::cross(v, glm::vec3(1, 0, 0)) : glm::cross(v, glm::vec3(0, 1, 0));
+        }
+
+        /**
+         * reduce the simplex to the feature closest to the origin and find the new search direction
+         *
+         * \return true if the simplex encloses the origin
+         */
+        static bool simplexLine(Simplex& simplex, glm::vec3& dir)
+        {
+            glm::vec3 a = simplex.points[0];
+            glm::vec3 b = simplex.points[1];
+
+            glm::vec3 ab = b - a;
+            glm::vec3 ao = -a;
+
+            if (sameDirection(ab, ao))
             {
-                //calculate triangle normal
-                glm::vec3 t_normal = glm::normalize(m1->getVertex(i).value().nor);
-        
-                float projection;
+                dir = glm::cross(glm::cross(ab, ao), ab);
 
-                //save bounds of the projected mesh
-                float m1_min;
-                float m1_max;
+                //origin lies on the line, any perpendicular direction will do
+                if (glm::dot(dir, dir) == 0.0f)
+                {
+                    dir = perpendicular(ab);
+                }
+            }
+            else
+            {
+                simplex.set(a);
+                dir = ao;
+            }
 
-                //project mesh 1 onto the triangle normal
-                for(u32 j = 0; j < m1_vertices.size(); j++)
+            return false;
+        }
+        static bool simplexTriangle(Simplex& simplex, glm::vec3& dir)
+        {
+            glm::vec3 a = simplex.points[0];
+            glm::vec3 b = simplex.points[1];
+            glm::vec3 c = simplex.points[2];
+
+            glm::vec3 ab  = b - a;
+            glm::vec3 ac  = c - a;
+            glm::vec3 ao  = -a;
+            glm::vec3 abc = glm::cross(ab, ac);
+
+            if (sameDirection(glm::cross(abc, ac), ao))
+            {
+                if (sameDirection(ac, ao))
                 {
-                    projection = glm::dot(m1->getVertex(j).value().pos, t_normal);
+                    simplex.set(a, c);
+                    dir = glm::cross(glm::cross(ac, ao), ac);
+                    return false;
+                }
 
-                    if(j == 0)
-                    {
-                        m1_min = m1_max = projection;
-                    }
-                    else
-                    {
-                        if(projection < m1_min) { m1_min = projection; }
-                        if(projection > m1_max) { m1_max = projection; }
-                    }
+                simplex.set(a, b);
+                return simplexLine(simplex, dir);
+            }
+
+            if (sameDirection(glm::cross(ab, abc), ao))
+            {
+                simplex.set(a, b);
+                return simplexLine(simplex, dir);
+            }
+
+            if (sameDirection(abc, ao))
+            {
+                dir = abc;
+            }
+            else
+            {
+                simplex.set(a, c, b);
+                dir = -abc;
+            }
+
+            return false;
+        }
+        static bool simplexTetrahedron(Simplex& simplex, glm::vec3& dir)
+        {
+            glm::vec3 a = simplex.points[0];
+            glm::vec3 b = simplex.points[1];
+            glm::vec3 c = simplex.points[2];
+            glm::vec3 d = simplex.points[3];
+
+            glm::vec3 ab = b - a;
+            glm::vec3 ac = c - a;
+            glm::vec3 ad = d - a;
+            glm::vec3 ao = -a;
+
+            if (sameDirection(glm::cross(ab, ac), ao))
+            {
+                simplex.set(a, b, c);
+                return simplexTriangle(simplex, dir);
+            }
+
+            if (sameDirection(glm::cross(ac, ad), ao))
+            {
+                simplex.set(a, c, d);
+                return simplexTriangle(simplex, dir);
+            }
+
+            if (sameDirection(glm::cross(ad, ab), ao))
+            {
+                simplex.set(a, d, b);
+                return simplexTriangle(simplex, dir);
+            }
+
+            return true;
+        }
+
+        /**
+         * result of GJK, touching shapes or running out of iterations is undecided
+         */
+        enum class ConvexResult
+        {
+            Separated,
+            Intersecting,
+            Undecided
+        };
+
+        /**
+         * GJK, builds simplexes of the minkowski difference until one of them encloses the origin
+         *
+         * \return Intersecting if the shapes intersect, the simplex is the enclosing tetrahedron then
+         */
+        static ConvexResult gilbertJohnsonKeerthi(const Support& support1, const Support& support2, const glm::vec3& initial_dir, Simplex& simplex)
+        {
+            glm::vec3 dir = glm::dot(initial_dir, initial_dir) > 0.0f ? initial_dir : glm::vec3(1, 0, 0);
+
+            simplex.size = 0;
+            simplex.push(support1(dir) - support2(-dir));
+
+            dir = -simplex.points[0];
+
+            for (u32 i = 0; i < MaxConvexIterations; i++)
+            {
+                //origin lies on the simplex, the shapes are only touching
+                if (glm::dot(dir, dir) == 0.0f)
+                {
+                    return ConvexResult::Undecided;
                 }
 
-                //save bounds of the projected mesh
-                float m2_min;
-                float m2_max;
+                glm::vec3 point = support1(dir) - support2(-dir);
 
-                //project mesh 2 onto the triangle normal
-                for(u32 j = 0; j < m2_vertices.size(); j++)
+                //the furthest point didn't get past the origin -> there is a gap between the shapes
+                if (glm::dot(point, dir) < 0.0f)
                 {
-                    projection = glm::dot(m2->getVertex(j).value().pos, t_normal);
+                    return ConvexResult::Separated;
+                }
 
-                    if(j == 0)
-                    {
-                        m2_min = m2_max = projection;
-                    }
-                    else
-                    {
-                        if(projection < m2_min) { m2_min = projection; }
-                        if(projection > m2_max) { m2_max = projection; }
-                    }
+                //no progress, the origin lies on the boundary of the simplex
+                if (glm::dot(point - simplex.points[0], dir) <= ConvexTolerance * glm::length(dir))
+                {
+                    return ConvexResult::Undecided;
                 }
 
-                //if there is a gap between meshes -> no collision
-                if(!(m1_min <= m2_max && m2_min <= m1_max))
+                simplex.push(point);
+
+                bool enclosed = false;
+
+                switch (simplex.size)
                 {
-                    return res;
+                    case 2: enclosed = simplexLine(simplex, dir);        break;
+                    case 3: enclosed = simplexTriangle(simplex, dir);    break;
+                    case 4: enclosed = simplexTetrahedron(simplex, dir); break;
                 }
-                else
+
+                if (enclosed)
                 {
-                    //calculate the overlap
-                    float overlap = std::min(m1_max, m2_max) - std::max(m1_min, m2_min);
+                    return ConvexResult::Intersecting;
+                }
+            }
 
-                    //check if one mesh is inside the other
-                    if((m1_max < m2_max && m1_min > m2_min) || (m1_max > m2_max && m1_min < m2_min))
-                    {
-                        float mins = std::fabs(m1_min - m2_min);
-                        float maxs = std::fabs(m1_max - m2_max);
+            return ConvexResult::Undecided;
+        }
 
-                        if(mins < maxs) { overlap += mins; }
-                        else            { overlap += maxs; }
+        /**
+         * turn the simplex into a tetrahedron with volume by adding support points in extra directions,
+         * used when GJK stopped with the origin on the boundary of a degenerate simplex
+         *
+         * \return false if the minkowski difference is flat
+         */
+        static bool completeSimplex(const Support& support1, const Support& support2, Simplex& simplex)
+        {
+            static const glm::vec3 directions[] =
+            {
+                {  1,  0,  0 }, { -1,  0,  0 }, {  0,  1,  0 }, {  0, -1,  0 }, {  0,  0,  1 }, {  0,  0, -1 },
+                {  1,  1,  1 }, { -1, -1, -1 }, {  1, -1,  1 }, { -1,  1, -1 }, {  1,  1, -1 }, { -1, -1,  1 },
+                { -1,  1,  1 }, {  1, -1, -1 }
+            };
+
+            glm::vec3 points[4];
+            u32       count = 0;
+
+            //keep a point only if it isn't in the span of the points so far
+            auto add_point = [&](const glm::vec3& point)
+            {
+                if (count == 0)
+                {
+                    points[count++] = point;
+                }
+                else if (count == 1)
+                {
+                    if (glm::length(point - points[0]) > ConvexTolerance)
+                    {
+                        points[count++] = point;
                     }
+                }
+                else if (count == 2)
+                {
+                    glm::vec3 edge = points[1] - points[0];
 
-                    //update the final overlap and minimal translation vector
-                    if(overlap < min_overlap)
+                    if (glm::length(glm::cross(edge, point - points[0])) > ConvexTolerance * glm::length(edge))
                     {
-                        min_overlap = overlap;
-                        min_trans_vec = t_normal * min_overlap;
+                        points[count++] = point;
+                    }
+                }
+                else if (count == 3)
+                {
+                    glm::vec3 normal = glm::cross(points[1] - points[0], points[2] - points[0]);
 
-                        if(glm::dot(delta, min_trans_vec) > 0)
-                        {
-                            min_trans_vec *= -1.0f;
-                        }
+                    if (std::fabs(glm::dot(normal, point - points[0])) > ConvexTolerance * glm::length(normal))
+                    {
+                        points[count++] = point;
                     }
                 }
+            };
+
+            for (u32 i = 0; i < simplex.size; i++)
+            {
+                add_point(simplex.points[i]);
             }
 
-            //for every triangle in mesh 2
-            for(u32 i = 0; i < m2_vertices.size(); i += 3)
+            //points off the plane of a triangle are found along its normal
+            if (count == 3)
             {
-                //calculate triangle normal
-                glm::vec3 t_normal = glm::normalize(m2->getVertex(i).value().nor);
-        
-                float projection;
+                glm::vec3 normal = glm::cross(points[1] - points[0], points[2] - points[0]);
 
-                //save bounds of the projected mesh
-                float m1_min;
-                float m1_max;
+                add_point(support1( normal) - support2(-normal));
+                add_point(support1(-normal) - support2( normal));
+            }
 
-                //project mesh 1 onto the triangle normal
-                for(u32 j = 0; j < m1_vertices.size(); j++)
+            for (const glm::vec3& dir : directions)
+            {
+                if (count == 4)
                 {
-                    projection = glm::dot(m1->getVertex(j).value().pos, t_normal);
+                    break;
+                }
+
+                add_point(support1(dir) - support2(-dir));
+            }
+
+            if (count != 4)
+            {
+                return false;
+            }
+
+            simplex.points[0] = points[0];
+            simplex.points[1] = points[1];
+            simplex.points[2] = points[2];
+            simplex.points[3] = points[3];
+            simplex.size      = 4;
 
-                    if(j == 0)
+            return true;
+        }
+
+        /**
+         * check if the tetrahedron is too flat to expand, the shapes are only touching then
+         */
+        static bool flatSimplex(const Simplex& simplex)
+        {
+            glm::vec3 ab = simplex.points[1] - simplex.points[0];
+            glm::vec3 ac = simplex.points[2] - simplex.points[0];
+            glm::vec3 ad = simplex.points[3] - simplex.points[0];
+
+            float edge   = std::max(glm::length(ab), std::max(glm::length(ac), glm::length(ad)));
+            float volume = std::fabs(glm::dot(ab, glm::cross(ac, ad)));
+
+            return volume <= ConvexTolerance * edge * edge * edge;
+        }
+
+        /**
+         * EPA, expands the tetrahedron from GJK towards the boundary of the minkowski difference
+         * until the face closest to the origin is found
+         *
+         * \return displacement of the first shape out of the second one
+         */
+        static glm::vec3 expandingPolytope(const Support& support1, const Support& support2, const Simplex& simplex)
+        {
+            struct Face
+            {
+                u32       a, b, c;
+                glm::vec3 normal;
+                float     distance;
+            };
+
+            std::vector<glm::vec3>           points(simplex.points, simplex.points + 4);
+            std::vector<Face>                faces;
+            std::vector<std::pair<u32, u32>> horizon;
+
+            //the origin may lie right on a face, so the faces are oriented away from the center of the tetrahedron instead
+            glm::vec3 interior = (points[0] + points[1] + points[2] + points[3]) / 4.0f;
+
+            auto add_face = [&](u32 a, u32 b, u32 c)
+            {
+                Face face { a, b, c, glm::cross(points[b] - points[a], points[c] - points[a]), 0.0f };
+
+                float length = glm::length(face.normal);
+
+                if (length == 0.0f)
+                {
+                    face.normal   = glm::vec3(0);
+                    face.distance = std::numeric_limits<float>::max();
+                }
+                else
+                {
+                    face.normal /= length;
+
+                    if (glm::dot(face.normal, points[a] - interior) < 0.0f)
                     {
-                        m1_min = m1_max = projection;
+                        std::swap(face.b, face.c);
+                        face.normal = -face.normal;
                     }
-                    else
+
+                    face.distance = std::max(glm::dot(face.normal, points[a]), 0.0f);
+                }
+
+                faces.push_back(face);
+            };
+
+            add_face(0, 1, 2);
+            add_face(0, 3, 1);
+            add_face(0, 2, 3);
+            add_face(1, 3, 2);
+
+            u32 closest = 0;
+
+            for (u32 i = 0; i < MaxConvexIterations; i++)
+            {
+                closest = 0;
+                for (u32 f = 1; f < faces.size(); f++)
+                {
+                    if (faces[f].distance < faces[closest].distance)
                     {
-                        if(projection < m1_min) { m1_min = projection; }
-                        if(projection > m1_max) { m1_max = projection; }
+                        closest = f;
                     }
                 }
 
-                //save bounds of the projected mesh
-                float m2_min;
-                float m2_max;
+                glm::vec3 normal = faces[closest].normal;
+                glm::vec3 point  = support1(normal) - support2(-normal);
 
-                //project mesh 2 onto the triangle normal
-                for(u32 j = 0; j < m2_vertices.size(); j++)
+                //the boundary can't be pushed further in this direction
+                if (glm::dot(normal, point) - faces[closest].distance < ConvexTolerance)
                 {
-                    projection = glm::dot(m2->getVertex(j).value().pos, t_normal);
+                    break;
+                }
+
+                //remove the faces the new point can see and remember the edges of the hole
+                horizon.clear();
 
-                    if(j == 0)
+                for (u32 f = 0; f < faces.size(); )
+                {
+                    if (glm::dot(faces[f].normal, point - points[faces[f].a]) > 0.0f)
                     {
-                        m2_min = m2_max = projection;
+                        std::pair<u32, u32> edges[3] = { { faces[f].a, faces[f].b }, { faces[f].b, faces[f].c }, { faces[f].c, faces[f].a } };
+
+                        for (auto& edge : edges)
+                        {
+                            //an edge shared by two removed faces isn't on the horizon
+                            auto reversed = std::find(horizon.begin(), horizon.end(), std::make_pair(edge.second, edge.first));
+
+                            if (reversed != horizon.end())
+                            {
+                                horizon.erase(reversed);
+                            }
+                            else
+                            {
+                                horizon.push_back(edge);
+                            }
+                        }
+
+                        faces[f] = faces.back();
+                        faces.pop_back();
                     }
                     else
                     {
-                        if(projection < m2_min) { m2_min = projection; }
-                        if(projection > m2_max) { m2_max = projection; }
+                        f++;
                     }
                 }
 
-                //if there is a gap between meshes -> no collision
-                if(!(m1_min <= m2_max && m2_min <= m1_max))
+                //the point didn't see any face or the polytope fell apart numerically
+                if (horizon.empty() || faces.size() + horizon.size() > MaxPolytopeFaces)
+                {
+                    break;
+                }
+
+                u32 point_index = static_cast<u32>(points.size());
+                points.push_back(point);
+
+                for (auto& edge : horizon)
+                {
+                    add_face(edge.first, edge.second, point_index);
+                }
+            }
+
+            closest = 0;
+            for (u32 f = 1; f < faces.size(); f++)
+            {
+                if (faces[f].distance < faces[closest].distance)
+                {
+                    closest = f;
+                }
+            }
+
+            return -faces[closest].normal * faces[closest].distance;
+        }
+
+        /**
+         * convex vs convex, GJK finds out if the shapes intersect and EPA finds the penetration
+         */
+        Data ConvexVsConvex(const Support& support1, const Support& support2, const glm::vec3& dir)
+        {
+            Data    res;
+            Simplex simplex;
+
+            ConvexResult result = gilbertJohnsonKeerthi(support1, support2, dir, simplex);
+
+            if (result == ConvexResult::Separated)
+            {
+                return res;
+            }
+
+            //the origin is on the boundary of a degenerate simplex, EPA decides between touching and penetrating
+            if (result == ConvexResult::Undecided || flatSimplex(simplex))
+            {
+                if (!completeSimplex(support1, support2, simplex))
                 {
                     return res;
                 }
-                else
+            }
+
+            glm::vec3 displacement = expandingPolytope(support1, support2, simplex);
+
+            if (glm::length(displacement) > ConvexTolerance)
+            {
+                res.occurred     = true;
+                res.displacement = displacement;
+            }
+
+            return res;
+        }
+
+        /**
+         * convex vs convex, only finds out if the shapes intersect, touching shapes count as intersecting
+         */
+        bool ConvexVsConvexIntersect(const Support& support1, const Support& support2, const glm::vec3& dir)
+        {
+            Simplex simplex;
+            return gilbertJohnsonKeerthi(support1, support2, dir, simplex) != ConvexResult::Separated;
+        }
+
+        /**
+         * mesh vs mesh, tests the convex hulls of the meshes
+         */
+        Data MeshVsMeshConvex(SceneObject* m1, SceneObject* m2)
+        {
+            return ConvexVsConvex([m1](const glm::vec3& dir) { return m1->support(dir); },
+                                  [m2](const glm::vec3& dir) { return m2->support(dir); },
+                                  m1->pos() - m2->pos());
+        }
+
+        /**
+         * mesh vs mesh using separating axes theorem algorithm
+         */
+        Data MeshVsMeshSeparatingAxesTheorem(SceneObject* m1, SceneObject* m2)
+        {
+            Data res;
+
+            const ConvexHull& hull1 = m1->hull();
+            const ConvexHull& hull2 = m2->hull();
+
+            //flat meshes have no hull features to test
+            if (hull1.empty() || hull2.empty())
+            {
+                return MeshVsMeshConvex(m1, m2);
+            }
+
+            const SceneObject::Transform& t1 = m1->transform();
+            const SceneObject::Transform& t2 = m2->transform();
+
+            //variables for calculation of minimal translation vector
+            float     min_overlap   = std::numeric_limits<float>::max();
+            glm::vec3 min_trans_vec = glm::vec3(0);
+
+            //project both hulls onto the axis, false if there is a gap between them
+            auto test_axis = [&](glm::vec3 axis)
+            {
+                float length = glm::length(axis);
+
+                //parallel edges don't give an axis
+                if (length < ConvexTolerance)
                 {
-                    //calculate the overlap
-                    float overlap = std::min(m1_max, m2_max) - std::max(m1_min, m2_min);
+                    return true;
+                }
 
-                    //check if one mesh is inside the other
-                    if((m1_max < m2_max && m1_min > m2_min) || (m1_max > m2_max && m1_min < m2_min))
-                    {
-                        float mins = std::fabs(m1_min - m2_min);
-                        float maxs = std::fabs(m1_max - m2_max);
+                axis /= length;
 
-                        if(mins < maxs) { overlap += mins; }
-                        else            { overlap += maxs; }
-                    }
+                float m1_max = glm::dot(m1->support( axis), axis);
+                float m1_min = glm::dot(m1->support(-axis), axis);
+                float m2_max = glm::dot(m2->support( axis), axis);
+                float m2_min = glm::dot(m2->support(-axis), axis);
 
-                    //update the final overlap and minimal translation vector
-                    if(overlap < min_overlap)
-                    {
-                        min_overlap = overlap;
-                        min_trans_vec = t_normal * min_overlap;
+                if (!(m1_min <= m2_max && m2_min <= m1_max))
+                {
+                    return false;
+                }
 
-                        if(glm::dot(delta, min_trans_vec) > 0)
-                        {
-                            min_trans_vec *= -1.0f;
-                        }
+                //mesh 1 can leave either way along the axis
+                float forward  = m2_max - m1_min;
+                float backward = m1_max - m2_min;
+
+                if (forward < min_overlap)
+                {
+                    min_overlap   = forward;
+                    min_trans_vec = axis * forward;
+                }
+                if (backward < min_overlap)
+                {
+                    min_overlap   = backward;
+                    min_trans_vec = -axis * backward;
+                }
+
+                return true;
+            };
+
+            //normals are mapped by the inverse transposed linear part, edges by the linear part
+            for (const glm::vec3& normal : hull1.normals())
+            {
+                if (!test_axis((t1.rotation * normal) * t1.inv_scale))
+                {
+                    return res;
+                }
+            }
+
+            for (const glm::vec3& normal : hull2.normals())
+            {
+                if (!test_axis((t2.rotation * normal) * t2.inv_scale))
+                {
+                    return res;
+                }
+            }
+
+            for (const glm::vec3& edge1 : hull1.edges())
+            {
+                glm::vec3 world_edge1 = (t1.rotation * edge1) * m1->get_scale();
+
+                for (const glm::vec3& edge2 : hull2.edges())
+                {
+                    if (!test_axis(glm::cross(world_edge1, (t2.rotation * edge2) * m2->get_scale())))
+                    {
+                        return res;
                     }
                 }
             }
@@ -1532,31 +2134,31 @@ namespace Engine3D
         }
     
         /**
-         * mesh vs mesh
+         * mesh vs mesh, only triangles from overlapping branches of the two hierarchies are tested
          */
          Data MeshVsMesh(SceneObject* m1, SceneObject* m2)
          {
             Data res;
-            
-            //extract vertices
-            const std::vector<Vertex>& m1_vertices = *m1->vertices();
-            const std::vector<Vertex>& m2_vertices = *m2->vertices();
-            
-            for(u32 i = 0; i < m1_vertices.size(); i += 3)
+
+            //triangles can't touch if the hulls around them don't
+            if (!ConvexVsConvexIntersect([m1](const glm::vec3& dir) { return m1->support(dir); },
+                                         [m2](const glm::vec3& dir) { return m2->support(dir); },
+                                         m1->pos() - m2->pos()))
             {
-                for(u32 j = 0; j < m2_vertices.size(); j += 3)
-                {
-                    Triangle t1 = m1->constructTriangle(i);
-                    Triangle t2 = m2->constructTriangle(j);
-                    
-                    res = TriangleVsTriangle(t1, t2);
-                    if(res)
-                    {
-                        return res;
-                    }
-                }
+                return res;
             }
-             
+
+            BoundingVolumeHierarchy::traversePairs(m1->bvh(), m2->bvh(),
+                [&](const BoundingVolumeHierarchy::Node& node1, const BoundingVolumeHierarchy::Node& node2)
+                {
+                    return BoundingVolumeHierarchy::overlaps(m1->localToWorld(node1.box), m2->localToWorld(node2.box));
+                },
+                [&](u32 triangle1, u32 triangle2)
+                {
+                    res = TriangleVsTriangle(m1->constructTriangle(triangle1 * 3), m2->constructTriangle(triangle2 * 3));
+                    return !res;
+                });
+
             return res;
          }
 
@@ -1564,85 +2166,44 @@ namespace Engine3D
          {
              Data res;
 
-             //extract vertices
-             const std::vector<Vertex>& m1_vertices = *m1->vertices();
-             const std::vector<Vertex>& m2_vertices = *m2->vertices();
+             //hull of the first mesh swept along the velocity
+             Support swept_support = [&](const glm::vec3& dir)
+             {
+                 glm::vec3 point = m1->support(dir);
+                 return glm::dot(dir, velocity) > 0.0f ? point + velocity : point;
+             };
 
-             for (u32 i = 0; i < m1_vertices.size(); i += 3)
+             if (!ConvexVsConvexIntersect(swept_support, [m2](const glm::vec3& dir) { return m2->support(dir); }, m1->pos() - m2->pos()))
              {
-                 for (u32 j = 0; j < m2_vertices.size(); j += 3)
-                 {
-                     Triangle t1 = m1->constructTriangle(i);
-                     Triangle t2 = m2->constructTriangle(j);
-
-                     res = TriangleVsTriangleSweep(t1, velocity, t2);
-                     if (res)
-                     {
-                         return res;
-                     }
-                 }
+                 return res;
              }
 
+             BoundingVolumeHierarchy::traversePairs(m1->bvh(), m2->bvh(),
+                 [&](const BoundingVolumeHierarchy::Node& node1, const BoundingVolumeHierarchy::Node& node2)
+                 {
+                     //extend the box of the first mesh over the whole sweep
+                     BoundingBox box1 = m1->localToWorld(node1.box);
+                     box1.min = glm::min(box1.min, box1.min + velocity);
+                     box1.max = glm::max(box1.max, box1.max + velocity);
+
+                     return BoundingVolumeHierarchy::overlaps(box1, m2->localToWorld(node2.box));
+                 },
+                 [&](u32 triangle1, u32 triangle2)
+                 {
+                     res = TriangleVsTriangleSweep(m1->constructTriangle(triangle1 * 3), velocity, m2->constructTriangle(triangle2 * 3));
+                     return !res;
+                 });
+
              return res;
          }
 
+         /**
+          * mesh vs mesh, kept for the old subspace based callers, the hierarchy already
+          * restricts the test to the overlapping parts of the meshes
+          */
          Data MeshVsMeshPartial(SceneObject* m1, SceneObject* m2)
          {
-             Data res;
-
-             // go through every subspace of the first object
-             for (u32 z1 = 0; z1 < DivisionFactor; z1++)
-             {
-                 for (u32 y1 = 0; y1 < DivisionFactor; y1++)
-                 {
-                     for (u32 x1 = 0; x1 < DivisionFactor; x1++)
-                     {
-                         //construct a subspace bounding box
-                         Box box1 = m1->getDivisionBox(x1, y1, z1);
-
-                         // go through every subspace of the second object
-                         for (u32 z2 = 0; z2 < DivisionFactor; z2++)
-                         {
-                             for (u32 y2 = 0; y2 < DivisionFactor; y2++)
-                             {
-                                 for (u32 x2 = 0; x2 < DivisionFactor; x2++)
-                                 {
-                                     Box box2 = m2->getDivisionBox(x2, y2, z2);
-
-                                     //if them two boxes are overlapping -> potential collision
-                                     if (Collision::BoxVsBox(box1, box2))
-                                     {
-                                         const std::vector<u32>& partial_division1 = m1->getDivision(x1, y1, z1);
-                                         const std::vector<u32>& partial_division2 = m2->getDivision(x2, y2, z2);
-                                      
-                                         return res;
-
-                                         for (u32 i = 0; i < partial_division1.size(); i++)
-                                         {
-                                             for (u32 j = 0; j < partial_division2.size(); j++)
-                                             {
-                                                 u32 index1 = partial_division1[i];
-                                                 u32 index2 = partial_division2[j];
-
-                                                 Triangle t1 = m1->constructTriangle(index1 - (index1 % 3));
-                                                 Triangle t2 = m2->constructTriangle(index2 - (index2 % 3));
-
-                                                 res = TriangleVsTriangle(t1, t2);
-                                                 if (res)
-                                                 {
-                                                     return res;
-                                                 }
-                                             }
-                                         }
-                                     }
-                                 }
-                             }
-                         }
-                     }
-                 }
-             }
-
-             return res;
+             return MeshVsMesh(m1, m2);
          }
     };
 };
\ No newline at end of file
@@ -16,6 +16,8 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 */
 #pragma once
 
+#include <functional>
+
 #include <glm/glm.hpp>
 #include "Shapes.hpp"
 #include "SceneObject.hpp"
@@ -253,6 +255,31 @@ namespace Engine3D
                                  const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3);
         Data EllipsoidVsTriangle(const Ellipsoid& ellipsoid, const Triangle& triangle);
 
+        /**
+         * find triangles of the block the ellipsoid may collide with, the test is conservative,
+         * every triangle EllipsoidVsTriangle would report is in the mask
+         *
+         * \arg pos   - 3D center of the ellipsoid
+         * \arg dims  - width, height and depth of the ellipsoid
+         * \arg block - triangles to test
+         *
+         * \return bit mask of the candidate triangles
+         */
+        u32 EllipsoidVsTriangleBlockCandidates(const glm::vec3& pos, const glm::vec3& dims, const TriangleBlock& block);
+
+        /**
+         * ellipsoid vs block of triangles, gives the same result as calling EllipsoidVsTriangle for every
+         * triangle of the block in order and moving the ellipsoid by each displacement,
+         * only the culling is vectorized, the candidates it leaves go through EllipsoidVsTriangle one by one
+         *
+         * \arg pos   - 3D center of the ellipsoid, moved by the displacements
+         * \arg dims  - width, height and depth of the ellipsoid
+         * \arg block - triangles to test
+         *
+         * \return sum of the displacements
+         */
+        Data EllipsoidVsTriangleBlock(glm::vec3& pos, const glm::vec3& dims, const TriangleBlock& block);
+
         /**
          * sweep ellipsoid vs triangle
          *
@@ -297,8 +324,43 @@ namespace Engine3D
         Data TriangleVsTriangleSweep(const glm::vec3& t1_p1, const glm::vec3& t1_p2, const glm::vec3& t1_p3, const glm::vec3& velocity,
                                      const glm::vec3& t2_p1, const glm::vec3& t2_p2, const glm::vec3& t2_p3);
         Data TriangleVsTriangleSweep(const Triangle& t1, const glm::vec3& velocity, const Triangle& t2);
+
+        /**
+         * support function of a convex shape, returns the point of the shape furthest in the direction
+         */
+        using Support = std::function<glm::vec3(const glm::vec3&)>;
+
+        static constexpr u32   MaxConvexIterations = 64;
+        static constexpr u32   MaxPolytopeFaces    = 512;
+        static constexpr float ConvexTolerance     = 1e-4f;
+
+        /**
+         * convex vs convex, GJK finds out if the shapes intersect and EPA finds the penetration
+         *
+         * \arg support1 - support function of the first shape
+         * \arg support2 - support function of the second shape
+         * \arg dir      - initial search direction, the delta between the shapes' centers works best
+         *
+         * \return displacement moves the first shape out of the second one
+         */
+        Data ConvexVsConvex(const Support& support1, const Support& support2, const glm::vec3& dir);
+
+        /**
+         * convex vs convex, only finds out if the shapes intersect without computing the penetration,
+         * the answer is conservative, touching shapes count as intersecting
+         */
+        bool ConvexVsConvexIntersect(const Support& support1, const Support& support2, const glm::vec3& dir);
+
+        /**
+         * mesh vs mesh, tests the convex hulls of the meshes
+         */
+        Data MeshVsMeshConvex(SceneObject* m1, SceneObject* m2);
+
         /**
          * mesh vs mesh using separating axes theorem algorithm
+         *
+         * \note - tests the face normals and edge cross products of the convex hulls,
+         *         the extents along an axis come from the hull support queries
          */
         Data MeshVsMeshSeparatingAxesTheorem(SceneObject* m1, SceneObject* m2);
         
@@ -0,0 +1,509 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "ConvexHull.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Engine3D
+{
+    namespace
+    {
+        //normals closer than this are treated as one direction
+        constexpr float DirectionTolerance = 1e-4f;
+
+        /**
+         * face used while the hull grows, keeps the points in front of it
+         */
+        struct BuildFace
+        {
+            u32              indices[3];
+            glm::vec3        normal;
+            float            offset;
+            std::vector<u32> outside;
+            bool             alive { true };
+        };
+
+        u64 edgeKey(u32 from, u32 to)
+        {
+            return (static_cast<u64>(from) << 32) | to;
+        }
+    }
+
+    /**
+     * build the hull using quickhull, the hull stays empty if the points are flat
+     */
+    void ConvexHull::build(const std::vector<glm::vec3>& input)
+    {
+        clear();
+
+        //triangle soups repeat every position a few times
+        std::vector<glm::vec3> points(input);
+
+        std::sort(points.begin(), points.end(), [](const glm::vec3& a, const glm::vec3& b)
+            {
+                if (a.x != b.x) return a.x < b.x;
+                if (a.y != b.y) return a.y < b.y;
+                return a.z < b.z;
+            });
+        points.erase(std::unique(points.begin(), points.end()), points.end());
+
+        if (points.size() < 4)
+        {
+            return;
+        }
+
+        //extreme points along the axes, they also give the size for the tolerance
+        u32 extremes[6] = { 0, 0, 0, 0, 0, 0 };
+
+        for (u32 i = 0; i < points.size(); i++)
+        {
+            for (u32 axis = 0; axis < 3; axis++)
+            {
+                if (points[i][axis] < points[extremes[axis * 2 + 0]][axis]) { extremes[axis * 2 + 0] = i; }
+                if (points[i][axis] > points[extremes[axis * 2 + 1]][axis]) { extremes[axis * 2 + 1] = i; }
+            }
+        }
+
+        glm::vec3 extent(points[extremes[1]].x - points[extremes[0]].x,
+                         points[extremes[3]].y - points[extremes[2]].y,
+                         points[extremes[5]].z - points[extremes[4]].z);
+
+        float tolerance = glm::length(extent) * 1e-5f;
+
+        //initial tetrahedron - the furthest pair of extremes, the point furthest from their line and from their plane
+        u32   i0 = 0, i1 = 0, i2 = 0, i3 = 0;
+        float best = 0.0f;
+
+        for (u32 a = 0; a < 6; a++)
+        {
+            for (u32 b = a + 1; b < 6; b++)
+            {
+                glm::vec3 delta    = points[extremes[a]] - points[extremes[b]];
+                float     distance = glm::dot(delta, delta);
+
+                if (distance > best)
+                {
+                    best = distance;
+                    i0   = extremes[a];
+                    i1   = extremes[b];
+                }
+            }
+        }
+
+        if (best <= tolerance * tolerance)
+        {
+            return;
+        }
+
+        glm::vec3 line = points[i1] - points[i0];
+        best = 0.0f;
+
+        for (u32 i = 0; i < points.size(); i++)
+        {
+            float distance = glm::length(glm::cross(line, points[i] - points[i0]));
+
+            if (distance > best)
+            {
+                best = distance;
+                i2   = i;
+            }
+        }
+
+        if (best <= tolerance * glm::length(line))
+        {
+            return;
+        }
+
+        glm::vec3 plane = glm::normalize(glm::cross(line, points[i2] - points[i0]));
+        best = 0.0f;
+
+        for (u32 i = 0; i < points.size(); i++)
+        {
+            float distance = std::fabs(glm::dot(plane, points[i] - points[i0]));
+
+            if (distance > best)
+            {
+                best = distance;
+                i3   = i;
+            }
+        }
+
+        if (best <= tolerance)
+        {
+            return;
+        }
+
+        //the first face has to look away from the fourth point
+        if (glm::dot(plane, points[i3] - points[i0]) > 0.0f)
+        {
+            std::swap(i1, i2);
+        }
+
+        std::vector<BuildFace>       faces;
+        std::unordered_map<u64, u32> edge_faces;
+
+        auto add_face = [&](u32 a, u32 b, u32 c)
+        {
+            glm::vec3 normal = glm::cross(points[b] - points[a], points[c] - points[a]);
+            float     length = glm::length(normal);
+
+            BuildFace face;
+            face.indices[0] = a;
+            face.indices[1] = b;
+            face.indices[2] = c;
+            face.normal     = length > 0.0f ? normal / length : normal;
+            face.offset     = glm::dot(face.normal, points[a]);
+
+            u32 index = static_cast<u32>(faces.size());
+
+            edge_faces[edgeKey(a, b)] = index;
+            edge_faces[edgeKey(b, c)] = index;
+            edge_faces[edgeKey(c, a)] = index;
+
+            faces.push_back(std::move(face));
+            return index;
+        };
+
+        auto distance = [&](const BuildFace& face, u32 point)
+        {
+            return glm::dot(face.normal, points[point]) - face.offset;
+        };
+
+        add_face(i0, i1, i2);
+        add_face(i1, i0, i3);
+        add_face(i2, i1, i3);
+        add_face(i0, i2, i3);
+
+        //every point goes to the first face it is in front of, the ones behind all faces are inside
+        for (u32 i = 0; i < points.size(); i++)
+        {
+            if (i == i0 || i == i1 || i == i2 || i == i3)
+            {
+                continue;
+            }
+
+            for (auto& face : faces)
+            {
+                if (distance(face, i) > tolerance)
+                {
+                    face.outside.push_back(i);
+                    break;
+                }
+            }
+        }
+
+        std::vector<u32>                   visit_stamps;
+        std::vector<u32>                   visible;
+        std::vector<std::pair<u32, u32>>   horizon;
+        std::vector<u32>                   orphans;
+        u32                                stamp = 0;
+
+        for (u32 current = 0; current < faces.size(); current++)
+        {
+            if (faces[current].alive == false || faces[current].outside.empty())
+            {
+                continue;
+            }
+
+            //the furthest point of the face is certainly a hull vertex, new faces are appended
+            //so the scan reaches them and the faces already passed never get new points
+            u32 eye = faces[current].outside.front();
+
+            for (u32 point : faces[current].outside)
+            {
+                if (distance(faces[current], point) > distance(faces[current], eye))
+                {
+                    eye = point;
+                }
+            }
+
+            //faces seen from the point are flooded across the edges, the border is the horizon
+            visit_stamps.resize(faces.size(), 0);
+            stamp++;
+
+            visible.clear();
+            horizon.clear();
+
+            visible.push_back(current);
+            visit_stamps[current] = stamp;
+
+            for (u32 i = 0; i < visible.size(); i++)
+            {
+                const BuildFace& face = faces[visible[i]];
+
+                for (u32 e = 0; e < 3; e++)
+                {
+                    u32 from = face.indices[e];
+                    u32 to   = face.indices[(e + 1) % 3];
+                    u32 next = edge_faces[edgeKey(to, from)];
+
+                    if (visit_stamps[next] == stamp)
+                    {
+                        continue;
+                    }
+
+                    if (distance(faces[next], eye) > 0.0f)
+                    {
+                        visit_stamps[next] = stamp;
+                        visible.push_back(next);
+                    }
+                    else
+                    {
+                        horizon.emplace_back(from, to);
+                    }
+                }
+            }
+
+            //faces behind the horizon are replaced by a cone to the point
+            orphans.clear();
+
+            for (u32 index : visible)
+            {
+                BuildFace& face = faces[index];
+
+                face.alive = false;
+
+                for (u32 point : face.outside)
+                {
+                    if (point != eye)
+                    {
+                        orphans.push_back(point);
+                    }
+                }
+
+                face.outside.clear();
+                face.outside.shrink_to_fit();
+
+                for (u32 e = 0; e < 3; e++)
+                {
+                    edge_faces.erase(edgeKey(face.indices[e], face.indices[(e + 1) % 3]));
+                }
+            }
+
+            u32 first_new = static_cast<u32>(faces.size());
+
+            for (auto& edge : horizon)
+            {
+                add_face(edge.first, edge.second, eye);
+            }
+
+            for (u32 point : orphans)
+            {
+                for (u32 index = first_new; index < faces.size(); index++)
+                {
+                    if (distance(faces[index], point) > tolerance)
+                    {
+                        faces[index].outside.push_back(point);
+                        break;
+                    }
+                }
+            }
+        }
+
+        //keep only the vertices used by the hull, triangles of one flat face are grouped to share the normal
+        std::vector<u32> remap(points.size(), std::numeric_limits<u32>::max());
+        std::vector<u32> groups(faces.size(), std::numeric_limits<u32>::max());
+        std::vector<u32> flood;
+
+        for (u32 index = 0; index < faces.size(); index++)
+        {
+            const BuildFace& face = faces[index];
+
+            if (face.alive == false)
+            {
+                continue;
+            }
+
+            Face result;
+            result.normal = face.normal;
+
+            for (u32 e = 0; e < 3; e++)
+            {
+                u32 point = face.indices[e];
+
+                if (remap[point] == std::numeric_limits<u32>::max())
+                {
+                    remap[point] = static_cast<u32>(m_points.size());
+                    m_points.push_back(points[point]);
+                }
+
+                result.indices[e] = remap[point];
+            }
+
+            result.offset = glm::dot(result.normal, m_points[result.indices[0]]);
+            m_faces.push_back(result);
+
+            if (groups[index] != std::numeric_limits<u32>::max())
+            {
+                continue;
+            }
+
+            //a new flat face, its normal is the one of the triangle it was found from
+            groups[index] = index;
+            m_normals.push_back(face.normal);
+
+            flood.assign(1, index);
+
+            while (flood.empty() == false)
+            {
+                const BuildFace& member = faces[flood.back()];
+                flood.pop_back();
+
+                for (u32 e = 0; e < 3; e++)
+                {
+                    u32 next = edge_faces[edgeKey(member.indices[(e + 1) % 3], member.indices[e])];
+
+                    if (groups[next] == std::numeric_limits<u32>::max() && glm::dot(face.normal, faces[next].normal) > 1.0f - DirectionTolerance)
+                    {
+                        groups[next] = index;
+                        flood.push_back(next);
+                    }
+                }
+            }
+        }
+
+        //every edge is visited once from the face where it goes from the lower to the higher index,
+        //parallel edges fall into the same cell of a grid over the directions
+        std::vector<std::pair<u32, u32>> links;
+        std::unordered_set<u64>          directions;
+
+        for (u32 index = 0; index < faces.size(); index++)
+        {
+            const BuildFace& face = faces[index];
+
+            if (face.alive == false)
+            {
+                continue;
+            }
+
+            for (u32 e = 0; e < 3; e++)
+            {
+                u32 from = face.indices[e];
+                u32 to   = face.indices[(e + 1) % 3];
+
+                if (from > to)
+                {
+                    continue;
+                }
+
+                links.emplace_back(remap[from], remap[to]);
+
+                //diagonals inside a flat face are no real edges
+                if (groups[edge_faces[edgeKey(to, from)]] == groups[index])
+                {
+                    continue;
+                }
+
+                glm::vec3 direction = glm::normalize(points[to] - points[from]);
+
+                //opposite directions are the same axis
+                if (direction.x < 0.0f || (direction.x == 0.0f && (direction.y < 0.0f || (direction.y == 0.0f && direction.z < 0.0f))))
+                {
+                    direction = -direction;
+                }
+
+                glm::vec3 cell = glm::floor(direction / DirectionTolerance + 0.5f);
+                u64       key  = (static_cast<u64>(static_cast<s64>(cell.x) & 0x1fffff) << 42) |
+                                 (static_cast<u64>(static_cast<s64>(cell.y) & 0x1fffff) << 21) |
+                                 (static_cast<u64>(static_cast<s64>(cell.z) & 0x1fffff));
+
+                if (directions.insert(key).second)
+                {
+                    m_edges.push_back(direction);
+                }
+            }
+        }
+
+        //adjacency in one array, offsets are built from the vertex degrees
+        m_adjacency_offsets.assign(m_points.size() + 1, 0);
+
+        for (auto& link : links)
+        {
+            m_adjacency_offsets[link.first  + 1]++;
+            m_adjacency_offsets[link.second + 1]++;
+        }
+
+        for (u32 i = 0; i < m_points.size(); i++)
+        {
+            m_adjacency_offsets[i + 1] += m_adjacency_offsets[i];
+        }
+
+        std::vector<u32> fill(m_adjacency_offsets.begin(), m_adjacency_offsets.end() - 1);
+        m_adjacency.resize(links.size() * 2);
+
+        for (auto& link : links)
+        {
+            m_adjacency[fill[link.first]++]  = link.second;
+            m_adjacency[fill[link.second]++] = link.first;
+        }
+    }
+
+    /**
+     * remove the hull
+     */
+    void ConvexHull::clear()
+    {
+        m_points.clear();
+        m_faces.clear();
+        m_normals.clear();
+        m_edges.clear();
+        m_adjacency_offsets.clear();
+        m_adjacency.clear();
+    }
+
+    /**
+     * get index of the hull vertex furthest in the direction,
+     * the vertex graph of a convex polytope has no local maxima so the climb ends at the global one
+     */
+    u32 ConvexHull::support(const glm::vec3& dir, u32 start) const
+    {
+        if (m_points.empty())
+        {
+            return 0;
+        }
+
+        u32   current = start < m_points.size() ? start : 0;
+        float best    = glm::dot(m_points[current], dir);
+
+        for (;;)
+        {
+            u32 next = current;
+
+            for (u32 i = m_adjacency_offsets[current]; i < m_adjacency_offsets[current + 1]; i++)
+            {
+                float value = glm::dot(m_points[m_adjacency[i]], dir);
+
+                if (value > best)
+                {
+                    best = value;
+                    next = m_adjacency[i];
+                }
+            }
+
+            if (next == current)
+            {
+                return current;
+            }
+
+            current = next;
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,126 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Types.hpp"
+
+namespace Engine3D
+{
+    /**
+     * convex hull of a point cloud
+     *
+     * built once from the mesh vertices, keeps the hull vertices with their adjacency
+     * for hill climbing support queries and the unique face normals and edge directions
+     * for separating axes tests
+     */
+    class ConvexHull
+    {
+    public:
+
+        /**
+         * triangle of the hull, indices are counter clockwise when looking at the outside
+         */
+        struct Face
+        {
+            u32       indices[3] { 0, 0, 0 };
+            glm::vec3 normal     { 0 };
+            float     offset     { 0 };
+        };
+
+        /**
+         * constructors
+         */
+        ConvexHull() {}
+        ConvexHull(const std::vector<glm::vec3>& points) { build(points); }
+
+        /**
+         * build the hull using quickhull, the hull stays empty if the points are flat
+         */
+        void build(const std::vector<glm::vec3>& points);
+
+        /**
+         * take over a hull built earlier, used when the hull is loaded from a cooked mesh
+         */
+        void assign(std::vector<glm::vec3>&& points, std::vector<Face>&& faces, std::vector<glm::vec3>&& normals, std::vector<glm::vec3>&& edges,
+                    std::vector<u32>&& adjacency_offsets, std::vector<u32>&& adjacency)
+        {
+            m_points            = std::move(points);
+            m_faces             = std::move(faces);
+            m_normals           = std::move(normals);
+            m_edges             = std::move(edges);
+            m_adjacency_offsets = std::move(adjacency_offsets);
+            m_adjacency         = std::move(adjacency);
+        }
+
+        /**
+         * remove the hull
+         */
+        void clear();
+
+        /**
+         * check if the hull was built
+         */
+        bool empty() const { return m_faces.empty(); }
+
+        /**
+         * get hull vertices
+         */
+        const std::vector<glm::vec3>& points() const { return m_points; }
+
+        /**
+         * get hull triangles
+         */
+        const std::vector<Face>& faces() const { return m_faces; }
+
+        /**
+         * get unique face normals, triangles of one flat face share the normal
+         */
+        const std::vector<glm::vec3>& normals() const { return m_normals; }
+
+        /**
+         * get unique edge directions, opposite directions count as the same one
+         */
+        const std::vector<glm::vec3>& edges() const { return m_edges; }
+
+        /**
+         * get vertex adjacency, neighbours of vertex i are adjacency()[adjacencyOffsets()[i] .. adjacencyOffsets()[i + 1])
+         */
+        const std::vector<u32>& adjacencyOffsets() const { return m_adjacency_offsets; }
+        const std::vector<u32>& adjacency()        const { return m_adjacency; }
+
+        /**
+         * get index of the hull vertex furthest in the direction
+         *
+         * \arg start - vertex the climb starts from, the last result for coherent queries
+         */
+        u32 support(const glm::vec3& dir, u32 start = 0) const;
+
+    private:
+
+        std::vector<glm::vec3> m_points;
+        std::vector<Face>      m_faces;
+        std::vector<glm::vec3> m_normals;
+        std::vector<glm::vec3> m_edges;
+
+        std::vector<u32>       m_adjacency_offsets;
+        std::vector<u32>       m_adjacency;
+    };
+};
\ No newline at end of file
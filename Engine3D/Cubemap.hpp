@@ -19,6 +19,7 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 #include <string>
 
 #include "File.hpp"
+#include "Cache.hpp"
 
 
 namespace Engine3D
@@ -62,6 +63,6 @@ namespace Engine3D
         /**
          * cubemap management
          */
-        std::string m_cubemap_id { "" };
+        CacheHandle<u32> m_cubemap;
     };
 };
\ No newline at end of file
@@ -18,21 +18,34 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "Macros.hpp"
 #include "Utility.hpp"
+#include "AssetLoader.hpp"
+#include "AssetManifest.hpp"
+#include "BoundingVolumeHierarchy.hpp"
+#include "Broadphase.hpp"
 #include "Cache.hpp"
+#include "CacheTelemetry.hpp"
 #include "Camera.hpp"
 #include "Canvas.hpp"
 #include "Cubemap.hpp"
 #include "Collision.hpp"
+#include "ConvexHull.hpp"
 #include "FBObject.hpp"
 #include "File.hpp"
+#include "FileWatcher.hpp"
 #include "FPSLimiter.hpp"
 #include "Gamepad.hpp"
+#include "LZ4.hpp"
+#include "VertexLayout.hpp"
 #include "Mesh.hpp"
+#include "MeshFile.hpp"
+#include "MeshOptimizer.hpp"
 #include "Music.hpp"
+#include "Pack.hpp"
 #include "Save.hpp"
 #include "JSONDocument.hpp"
 #include "SceneObject.hpp"
 #include "Shader.hpp"
+#include "ShaderFile.hpp"
 #include "Shapes.hpp"
 #include "Sound.hpp"
 #include "SpatialPartition.hpp"
@@ -40,6 +53,7 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 #include "Text.hpp"
 #include "Types.hpp"
 #include "Texture.hpp"
+#include "TextureFile.hpp"
 #include "BillboardObject.hpp"
 #include "Sprite.hpp"
 #include "Game.hpp"
@@ -16,8 +16,16 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 */
 #include "File.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 
+#if ENGINE3D_PLATFORM != WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 namespace Engine3D
 {
     /**
@@ -44,6 +52,22 @@ namespace Engine3D
      */
     void File::open(const char* path, OpenMode mode/* = Mode::Read*/)
     {
+        //files of the mounted packs hide the files on the disk, their directories are merged with the ones on the disk
+        if(mode == OpenMode::Read && (Pack::open(path, m_pack_view) || Pack::isDirectory(path)))
+        {
+            m_pack_file     = m_pack_view.data != nullptr;
+            m_pack_dir      = !m_pack_file;
+            m_pack_position = 0;
+            m_dir_handle    = m_pack_dir ? opendir(path) : nullptr;
+
+            m_path = std::string(path);
+            if(m_path[m_path.size() - 1] == '/' || m_path[m_path.size() - 1] == '\\')
+            {
+                m_path.pop_back();
+            }
+            return;
+        }
+
         //try to open file as a directory
         m_dir_handle = opendir(path);
             
@@ -92,6 +116,11 @@ namespace Engine3D
             fclose(m_file_handle);
             m_file_handle = nullptr;
         }
+        m_pack_file      = false;
+        m_pack_dir       = false;
+        m_pack_view.data = nullptr;
+        m_pack_view.size = 0;
+        m_pack_view.buffer.clear();
         m_path.clear();
     }
         
@@ -100,6 +129,11 @@ namespace Engine3D
         */
     u64 File::size()
     {
+        if(m_pack_file)
+        {
+            return m_pack_view.size;
+        }
+
         if(m_file_handle == nullptr)
         {
             return 0;
@@ -123,6 +157,18 @@ namespace Engine3D
     std::vector<u8> File::read(u64 num_bytes/* = 0*/)
     {        
         std::vector<u8> result;
+
+        if(m_pack_file)
+        {
+            //whole file is read from the start like the file on the disk below
+            u64 begin = num_bytes == 0 ? 0 : m_pack_position;
+            u64 end   = num_bytes == 0 ? m_pack_view.size : std::min(m_pack_position + num_bytes, m_pack_view.size);
+
+            result.assign(m_pack_view.data + begin, m_pack_view.data + end);
+            m_pack_position = num_bytes == 0 ? 0 : end;
+
+            return result;
+        }
             
         if(m_file_handle == nullptr)
         {
@@ -142,14 +188,14 @@ namespace Engine3D
             }
                 
             result.resize(static_cast<u32>(result_size));
-            fread(&result[0], 1, static_cast<size_t>(result_size), m_file_handle);
+            fread(result.data(), 1, static_cast<size_t>(result_size), m_file_handle);
                 
             fseek(m_file_handle, 0, SEEK_SET);
         }
         else
         {
             result.resize(static_cast<u32>(num_bytes));
-            fread(&result[0], 1, static_cast<size_t>(num_bytes), m_file_handle);
+            fread(result.data(), 1, static_cast<size_t>(num_bytes), m_file_handle);
         }
 
         return result;
@@ -172,6 +218,11 @@ namespace Engine3D
         */
     int File::readByte()
     {
+        if(m_pack_file)
+        {
+            return m_pack_position < m_pack_view.size ? m_pack_view.data[m_pack_position++] : File::Eof;
+        }
+
         if(m_file_handle == nullptr)
         {
             return File::Eof;
@@ -185,7 +236,8 @@ namespace Engine3D
         */
     u64 File::write(const char* data, u64 size)
     {
-        if(failed())
+        //files of the packs are read only
+        if(m_file_handle == nullptr)
         {
             //TODO: error
             return 0;
@@ -220,6 +272,11 @@ namespace Engine3D
     std::vector<std::string> File::list()
     {
         std::vector<std::string> result;
+
+        if(m_pack_dir)
+        {
+            result = Pack::list(m_path);
+        }
             
         if(m_dir_handle == nullptr)
         {
@@ -227,14 +284,152 @@ namespace Engine3D
         }
             
         dirent* entry = nullptr;
+        u64     packed = result.size();
             
         while((entry = readdir(m_dir_handle)))
         {
-            result.emplace_back(entry->d_name);
+            if(std::find(result.begin(), result.begin() + packed, entry->d_name) == result.begin() + packed)
+            {
+                result.emplace_back(entry->d_name);
+            }
         }
             
         return result;
     }
+
+    /**
+     * map the file, opened() is false if it doesn't exist or is empty
+     */
+    void MappedFile::open(const std::string& path)
+    {
+        close();
+
+        Pack::View view;
+
+        if (Pack::open(path, view))
+        {
+            //the file stays empty like an empty file on the disk
+            if (view.size > 0)
+            {
+                m_buffer = std::move(view.buffer);
+                m_data   = m_buffer.empty() ? view.data : m_buffer.data();
+                m_size   = view.size;
+                m_packed = true;
+            }
+            return;
+        }
+
+#if ENGINE3D_PLATFORM == WINDOWS
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+
+        LARGE_INTEGER size;
+
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (mapping == nullptr)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        m_data           = static_cast<const u8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        m_size           = static_cast<u64>(size.QuadPart);
+        m_file_handle    = file;
+        m_mapping_handle = mapping;
+
+        if (m_data == nullptr)
+        {
+            close();
+        }
+#else
+        int descriptor = ::open(path.c_str(), O_RDONLY);
+
+        if (descriptor < 0)
+        {
+            return;
+        }
+
+        struct stat info;
+
+        if (fstat(descriptor, &info) != 0 || info.st_size == 0)
+        {
+            ::close(descriptor);
+            return;
+        }
+
+        void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+        //the mapping stays valid after the descriptor is closed
+        ::close(descriptor);
+
+        if (data == MAP_FAILED)
+        {
+            return;
+        }
+
+        m_data = static_cast<const u8*>(data);
+        m_size = static_cast<u64>(info.st_size);
+#endif
+    }
+
+    /**
+     * unmap the file
+     */
+    void MappedFile::close()
+    {
+        if (m_packed)
+        {
+            m_data   = nullptr;
+            m_size   = 0;
+            m_packed = false;
+            m_buffer.clear();
+            return;
+        }
+
+#if ENGINE3D_PLATFORM == WINDOWS
+        if (m_data != nullptr)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping_handle != nullptr)
+        {
+            CloseHandle(m_mapping_handle);
+        }
+        if (m_file_handle != nullptr)
+        {
+            CloseHandle(m_file_handle);
+        }
+
+        m_mapping_handle = nullptr;
+        m_file_handle    = nullptr;
+#else
+        if (m_data != nullptr)
+        {
+            munmap(const_cast<u8*>(m_data), static_cast<size_t>(m_size));
+        }
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    /**
+     * destructor
+     */
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
 };
 
 
@@ -29,6 +29,7 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 #include <cstdio>
 
 #include "Types.hpp"
+#include "Pack.hpp"
 
 namespace Engine3D
 {
@@ -84,8 +85,8 @@ namespace Engine3D
         /**
             * check if file is opened
             */
-        bool opened() { return m_file_handle != nullptr || m_dir_handle != nullptr; }
-        bool failed() { return m_file_handle == nullptr && m_dir_handle == nullptr; }
+        bool opened() { return isFile() || isDir(); }
+        bool failed() { return !opened(); }
             
         /**
             * read raw portion of file
@@ -123,11 +124,11 @@ namespace Engine3D
         /**
             * did we open a file?
             */
-        bool isFile() { return m_file_handle != nullptr; }
+        bool isFile() { return m_file_handle != nullptr || m_pack_file; }
         /**
             * did we open a directory?
             */
-        bool isDir()  { return m_dir_handle  != nullptr; }
+        bool isDir()  { return m_dir_handle  != nullptr || m_pack_dir; }
             
         /**
             * if we opened a directory we can list all file paths inside
@@ -152,8 +153,70 @@ namespace Engine3D
         
         FILE* m_file_handle { nullptr };
         DIR*  m_dir_handle  { nullptr };
+
+        //file or directory found in a mounted pack, read only
+        bool       m_pack_file     { false };
+        bool       m_pack_dir      { false };
+        Pack::View m_pack_view;
+        u64        m_pack_position { 0 };
             
         std::string m_path  { "" };
     };
 
+    /**
+     * read only view of a whole file mapped into memory,
+     * the pages are loaded by the system when they are touched
+     */
+    class MappedFile
+    {
+    public:
+
+        /**
+         * constructors
+         */
+        MappedFile() {}
+        MappedFile(const std::string& path) { open(path); }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        /**
+         * destructor
+         */
+       ~MappedFile();
+
+        /**
+         * map the file, opened() is false if it doesn't exist or is empty,
+         * files of the mounted packs are used instead of the files on the disk
+         */
+        void open(const std::string& path);
+
+        /**
+         * unmap the file
+         */
+        void close();
+
+        /**
+         * check if file is mapped
+         */
+        bool opened() const { return m_data != nullptr; }
+
+        /**
+         * get mapped bytes
+         */
+        const u8* data() const { return m_data; }
+        u64       size() const { return m_size; }
+
+    private:
+
+        const u8* m_data { nullptr };
+        u64       m_size { 0 };
+
+        //file of a mounted pack, the mapping of the pack or the decompressed copy isn't unmapped
+        bool            m_packed { false };
+        std::vector<u8> m_buffer;
+#if ENGINE3D_PLATFORM == WINDOWS
+        void*     m_file_handle    { nullptr };
+        void*     m_mapping_handle { nullptr };
+#endif
+    };
+
 };
\ No newline at end of file
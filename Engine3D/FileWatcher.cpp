@@ -0,0 +1,238 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "FileWatcher.hpp"
+
+#include "Macros.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#if ENGINE3D_PLATFORM == LINUX
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Engine3D
+{
+#if ENGINE3D_PLATFORM == LINUX
+    namespace
+    {
+        /**
+         * file watched in a directory, the whole directory if the name is empty
+         */
+        struct Watch
+        {
+            u32         id;
+            std::string name;
+        };
+
+        /**
+         * directory watched by inotify
+         */
+        struct Directory
+        {
+            std::string        path;
+            std::vector<Watch> watches;
+        };
+
+        int                                            g_inotify { -1 };
+        u32                                            g_next_id { 1 };
+        std::unordered_map<int, Directory>             g_directories; //by watch descriptor
+        std::unordered_map<u32, int>                   g_descriptors; //watch descriptor of every watch
+        std::unordered_map<u32, std::function<void()>> g_callbacks;
+
+        /**
+         * inotify event of a finished write or of a file moved into the directory
+         */
+        constexpr u32 ChangeMask = IN_CLOSE_WRITE | IN_MOVED_TO;
+    }
+
+    /**
+     * watch file or directory
+     */
+    u32 FileWatcher::watch(const std::string& path, std::function<void()> callback)
+    {
+        if (g_inotify == -1)
+        {
+            g_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+            if (g_inotify == -1)
+            {
+                return 0;
+            }
+        }
+
+        struct stat status;
+
+        if (stat(path.c_str(), &status) != 0)
+        {
+            return 0;
+        }
+
+        //files are watched through their directory
+        std::string directory = path;
+        std::string name;
+
+        if (S_ISDIR(status.st_mode) == false)
+        {
+            u64 slash = path.find_last_of('/');
+            directory = slash == std::string::npos ? "." : path.substr(0, slash);
+            name      = slash == std::string::npos ? path : path.substr(slash + 1);
+        }
+
+        int descriptor = inotify_add_watch(g_inotify, directory.c_str(), ChangeMask);
+
+        if (descriptor == -1)
+        {
+            return 0;
+        }
+
+        u32 id = g_next_id++;
+
+        Directory& watched = g_directories[descriptor];
+        watched.path = directory;
+        watched.watches.push_back({ id, name });
+
+        g_descriptors[id] = descriptor;
+        g_callbacks[id]   = std::move(callback);
+
+        return id;
+    }
+
+    /**
+     * stop watching
+     */
+    void FileWatcher::unwatch(u32 id)
+    {
+        auto it = g_descriptors.find(id);
+
+        if (it == g_descriptors.end())
+        {
+            return;
+        }
+
+        int        descriptor = it->second;
+        Directory& watched    = g_directories[descriptor];
+
+        for (u64 i = 0; i < watched.watches.size(); i++)
+        {
+            if (watched.watches[i].id == id)
+            {
+                watched.watches.erase(watched.watches.begin() + i);
+                break;
+            }
+        }
+
+        if (watched.watches.empty())
+        {
+            inotify_rm_watch(g_inotify, descriptor);
+            g_directories.erase(descriptor);
+        }
+
+        g_descriptors.erase(it);
+        g_callbacks.erase(id);
+    }
+
+    /**
+     * call functions of the changed files
+     */
+    void FileWatcher::update()
+    {
+        if (g_inotify == -1)
+        {
+            return;
+        }
+
+        //editors write a file in several steps, every watch is notified once per update
+        std::vector<u32>        changed;
+        std::unordered_set<u32> seen;
+
+        alignas(inotify_event) char buffer[4096];
+
+        while (true)
+        {
+            ssize_t length = read(g_inotify, buffer, sizeof(buffer));
+
+            if (length <= 0)
+            {
+                break;
+            }
+
+            for (ssize_t offset = 0; offset < length; )
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += sizeof(inotify_event) + event->len;
+
+                auto it = g_directories.find(event->wd);
+
+                if (it == g_directories.end() || (event->mask & ChangeMask) == 0)
+                {
+                    continue;
+                }
+
+                std::string name = event->len > 0 ? event->name : "";
+
+                for (const Watch& watch : it->second.watches)
+                {
+                    if ((watch.name.empty() || watch.name == name) && seen.insert(watch.id).second)
+                    {
+                        changed.push_back(watch.id);
+                    }
+                }
+            }
+        }
+
+        //callbacks may add and remove watches
+        for (u32 id : changed)
+        {
+            auto it = g_callbacks.find(id);
+
+            if (it != g_callbacks.end())
+            {
+                std::function<void()> callback = it->second;
+                callback();
+            }
+        }
+    }
+
+    /**
+     * stop watching every file
+     */
+    void FileWatcher::destroy()
+    {
+        if (g_inotify != -1)
+        {
+            close(g_inotify);
+            g_inotify = -1;
+        }
+
+        g_directories.clear();
+        g_descriptors.clear();
+        g_callbacks.clear();
+    }
+#else
+    /**
+     * files aren't watched on this platform
+     */
+    u32  FileWatcher::watch(const std::string& path, std::function<void()> callback) { return 0; }
+    void FileWatcher::unwatch(u32 id) {}
+    void FileWatcher::update() {}
+    void FileWatcher::destroy() {}
+#endif
+};
\ No newline at end of file
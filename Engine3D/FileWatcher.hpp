@@ -0,0 +1,55 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <string>
+#include <functional>
+
+#include "Types.hpp"
+
+namespace Engine3D
+{
+    /**
+     * notifications about changed files, used to reload assets while the game runs
+     *
+     * the directories of the watched files are watched with inotify, so files replaced by editors
+     * that save into a new file and rename it are noticed too, the watching is a no-op on other platforms
+     */
+    namespace FileWatcher
+    {
+        /**
+         * call the function from update() after the file is written, a watched directory notifies
+         * about every file in it, return id of the watch, 0 if the file can't be watched
+         */
+        u32 watch(const std::string& path, std::function<void()> callback);
+
+        /**
+         * stop watching, the id may be 0
+         */
+        void unwatch(u32 id);
+
+        /**
+         * call functions of the files changed since the last call, each one once, called once per frame from the gl thread
+         */
+        void update();
+
+        /**
+         * stop watching every file
+         */
+        void destroy();
+    };
+};
\ No newline at end of file
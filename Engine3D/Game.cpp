@@ -21,6 +21,7 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 #include <chrono>
 #include <thread>
 #include <algorithm>
+#include <cmath>
 
 #include <SDL2/SDL_image.h>
 
@@ -28,6 +29,11 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "Sound.hpp"
 #include "TimeInterval.hpp"
+#include "AssetLoader.hpp"
+#include "CacheTelemetry.hpp"
+#include "FileWatcher.hpp"
+#include "AssetManifest.hpp"
+#include "Pack.hpp"
 
 namespace Engine3D
 {
@@ -61,6 +67,19 @@ namespace Engine3D
 
         System::init(argc, argv);
 
+        //files of the pack are used instead of the ones in the data folder
+        try
+        {
+            if (Pack::mount(System::getFullPath(Pack::DefaultPath)))
+            {
+                std::printf("[Game] mounted %s\n", Pack::DefaultPath);
+            }
+        }
+        catch (const std::runtime_error& error)
+        {
+            std::printf("[Game] %s\n", error.what());
+        }
+
         //init SDL
         SDL_Init(SDL_INIT_EVERYTHING);
 
@@ -139,6 +158,18 @@ namespace Engine3D
 
     void Game::destroy()
     {
+        AssetLoader::destroy();
+        FileWatcher::destroy();
+
+        try
+        {
+            CacheTelemetry::dump();
+        }
+        catch (const std::runtime_error& error)
+        {
+            std::printf("[Game] %s\n", error.what());
+        }
+
         m_main_fbo.clean();
         SDL_DestroyWindow(m_window);
         SDL_GL_DeleteContext(m_context);
@@ -185,10 +216,27 @@ namespace Engine3D
 
         std::printf("[Game] initializing game...\n");
         m_timer.start();
+
+        //files init() loaded on the last launch start loading all at once, init() then finds them in the caches
+        AssetManifest::prefetch(AssetManifest::DefaultPath);
+        AssetManifest::record();
+
         //call user defined initialization
         init();
 
-        std::printf("[Game] initializing game finished in: %f s\n", m_timer.end());
+        try
+        {
+            AssetManifest::save(AssetManifest::DefaultPath);
+        }
+        catch (const std::runtime_error& error)
+        {
+            std::printf("[Game] %s\n", error.what());
+        }
+
+        AssetManifest::release();
+
+        //assets requested by init() keep loading while the main loop runs
+        std::printf("[Game] initializing game finished in: %f s, %u assets still loading\n", m_timer.end(), AssetLoader::pending());
 
         std::printf("[Game] started main loop\n");
 
@@ -273,6 +321,10 @@ namespace Engine3D
 
             if (keyDown(Key::ESC)) { m_running = false; }
 
+            //reload assets whose files changed, then hand decoded assets to the gpu, a few every frame
+            FileWatcher::update();
+            AssetLoader::update();
+
             //capture start of the frame
             float new_time         = static_cast<float>(SDL_GetTicks());
             float frame_time       = new_time - previous_time;
@@ -321,6 +373,9 @@ namespace Engine3D
         glLoadIdentity();
         gluPerspective(cam.getFov(), m_proj_width_over_height, m_proj_near, m_proj_far);
 
+        //same scale as the projection matrix, the viewport is as tall as the window
+        m_lod_scale = 0.5f * m_dims.y / std::tan(glm::radians(cam.getFov()) * 0.5f);
+
         glMatrixMode(GL_MODELVIEW);
         glLoadIdentity();
         //update cam view
@@ -341,6 +396,8 @@ namespace Engine3D
         glLoadIdentity();
         glOrtho(m_proj_left, m_proj_right, m_proj_down, m_proj_up, m_proj_near, m_proj_far);
 
+        m_lod_scale = 0.0f;
+
         glMatrixMode(GL_MODELVIEW);
         glLoadIdentity();
         //update cam view
@@ -365,10 +422,14 @@ namespace Engine3D
         if (m_projection == ProjectionType::Perspective)
         {
             gluPerspective(cam.getFov(), m_proj_width_over_height, m_proj_near, m_proj_far);
+
+            //the objects pick their lods from it instead of reading the matrices back from the gl
+            m_lod_scale = 0.5f * m_dims.y / std::tan(glm::radians(cam.getFov()) * 0.5f);
         }
         else
         {
             glOrtho(m_proj_left, m_proj_right, m_proj_down, m_proj_up, m_proj_near, m_proj_far);
+            m_lod_scale = 0.0f;
         }
 
         //update view matrix
@@ -174,6 +174,12 @@ namespace Engine3D
          */
         glm::vec2 getDims() { return m_dims; }
 
+        /**
+         * get pixels an object of size 1 takes on screen at distance 1, updated by drawBegin3D() once per frame,
+         * 0 with the orthographic projection
+         */
+        float lodScale() const { return m_lod_scale; }
+
         /**
          * get last measured fps 
          */
@@ -235,5 +241,7 @@ namespace Engine3D
         float m_proj_up;
         float m_proj_near;
         float m_proj_far;
+
+        float m_lod_scale { 0 };
     };
 };
\ No newline at end of file
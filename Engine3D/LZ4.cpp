@@ -0,0 +1,224 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "LZ4.hpp"
+
+#include <cstring>
+#include <limits>
+
+namespace Engine3D
+{
+    namespace
+    {
+        constexpr u32 MinMatch     = 4;
+        constexpr u32 MaxOffset    = 65535;
+        constexpr u32 HashBits     = 16;
+        constexpr u64 LastLiterals = 5;  //the block ends with at least this many literals
+        constexpr u64 MatchLimit   = 12; //no match starts this close to the end
+
+        u32 read32(const u8* data)
+        {
+            u32 value;
+            std::memcpy(&value, data, sizeof(u32));
+            return value;
+        }
+
+        u32 hash(u32 sequence)
+        {
+            return (sequence * 2654435761u) >> (32 - HashBits);
+        }
+
+        /**
+         * write length above the 4 bits of the token as a run of bytes
+         */
+        void writeLength(std::vector<u8>& output, u64 length)
+        {
+            for (length -= 15; length >= 255; length -= 255)
+            {
+                output.push_back(255);
+            }
+
+            output.push_back(static_cast<u8>(length));
+        }
+
+        /**
+         * read length continuing the token, return false past the end of the data
+         */
+        bool readLength(const u8* data, u64 size, u64& position, u64& length)
+        {
+            u8 byte;
+
+            do
+            {
+                if (position >= size)
+                {
+                    return false;
+                }
+
+                byte    = data[position++];
+                length += byte;
+            }
+            while (byte == 255);
+
+            return true;
+        }
+
+        /**
+         * write literals followed by a match, the last sequence has no match
+         */
+        void writeSequence(std::vector<u8>& output, const u8* literals, u64 literal_length, u32 offset, u64 match_length)
+        {
+            u64 match_token = match_length >= MinMatch ? match_length - MinMatch : 0;
+
+            output.push_back(static_cast<u8>((std::min<u64>(literal_length, 15) << 4) | std::min<u64>(match_token, 15)));
+
+            if (literal_length >= 15)
+            {
+                writeLength(output, literal_length);
+            }
+
+            output.insert(output.end(), literals, literals + literal_length);
+
+            if (match_length == 0)
+            {
+                return;
+            }
+
+            output.push_back(static_cast<u8>(offset & 0xFF));
+            output.push_back(static_cast<u8>(offset >> 8));
+
+            if (match_token >= 15)
+            {
+                writeLength(output, match_token);
+            }
+        }
+    }
+
+    /**
+     * compress the data with greedy matching
+     */
+    std::vector<u8> LZ4::compress(const u8* data, u64 size)
+    {
+        std::vector<u8> result;
+        result.reserve(size + size / 255 + 16);
+
+        std::vector<u64> table(u64(1) << HashBits, std::numeric_limits<u64>::max());
+
+        u64 anchor = 0;
+        u64 i      = 0;
+
+        while (size > MatchLimit && i < size - MatchLimit)
+        {
+            u32 sequence  = read32(data + i);
+            u32 slot      = hash(sequence);
+            u64 candidate = table[slot];
+            table[slot]   = i;
+
+            if (candidate == std::numeric_limits<u64>::max() || i - candidate > MaxOffset || read32(data + candidate) != sequence)
+            {
+                i++;
+                continue;
+            }
+
+            u64 length = MinMatch;
+
+            while (i + length < size - LastLiterals && data[candidate + length] == data[i + length])
+            {
+                length++;
+            }
+
+            writeSequence(result, data + anchor, i - anchor, static_cast<u32>(i - candidate), length);
+
+            i     += length;
+            anchor = i;
+        }
+
+        writeSequence(result, data + anchor, size - anchor, 0, 0);
+
+        return result;
+    }
+
+    /**
+     * decompress block into the output of the original size
+     */
+    bool LZ4::decompress(const u8* data, u64 size, u8* output, u64 output_size)
+    {
+        u64 position        = 0;
+        u64 output_position = 0;
+
+        while (position < size)
+        {
+            u8  token          = data[position++];
+            u64 literal_length = token >> 4;
+
+            if (literal_length == 15 && readLength(data, size, position, literal_length) == false)
+            {
+                return false;
+            }
+
+            if (literal_length > size - position || literal_length > output_size - output_position)
+            {
+                return false;
+            }
+
+            if (literal_length > 0)
+            {
+                std::memcpy(output + output_position, data + position, literal_length);
+            }
+
+            position        += literal_length;
+            output_position += literal_length;
+
+            //the last sequence has only literals
+            if (position == size)
+            {
+                break;
+            }
+
+            if (size - position < 2)
+            {
+                return false;
+            }
+
+            u64 offset = data[position] | (data[position + 1] << 8);
+            position  += 2;
+
+            u64 match_length = token & 15;
+
+            if (match_length == 15 && readLength(data, size, position, match_length) == false)
+            {
+                return false;
+            }
+
+            match_length += MinMatch;
+
+            if (offset == 0 || offset > output_position || match_length > output_size - output_position)
+            {
+                return false;
+            }
+
+            //the match may overlap the bytes it writes
+            for (u64 j = 0; j < match_length; j++)
+            {
+                output[output_position + j] = output[output_position + j - offset];
+            }
+
+            output_position += match_length;
+        }
+
+        return output_position == output_size;
+    }
+};
\ No newline at end of file
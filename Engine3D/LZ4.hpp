@@ -0,0 +1,41 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <vector>
+
+#include "Types.hpp"
+
+namespace Engine3D
+{
+    /**
+     * lz4 block format, fast to decode so compressed files don't slow the loading down,
+     * the data is framed by the caller, which stores the sizes
+     */
+    namespace LZ4
+    {
+        /**
+         * compress the data with greedy matching
+         */
+        std::vector<u8> compress(const u8* data, u64 size);
+
+        /**
+         * decompress block into the output of the original size, return false if the block is corrupted
+         */
+        bool decompress(const u8* data, u64 size, u8* output, u64 output_size);
+    };
+};
\ No newline at end of file
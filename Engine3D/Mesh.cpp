@@ -15,11 +15,14 @@ You should have received a copy of the GNU General Public License
 along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 */
 #include "Mesh.hpp"
+#include "MeshFile.hpp"
 
 #include <unordered_map>
 #include <limits>
 #include <cstdio>
+#include <cstdint>
 #include <stdexcept>
+#include <filesystem>
 
 #include "Macros.hpp"
 
@@ -29,350 +32,178 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 
 namespace Engine3D
 {
-    /**
-     * load vertices from file
-     */
-    Vertices meshCacheLoadingFunction(File& input_file)
+    namespace
     {
-        std::printf("Mesh() log: loading file: %s\n", input_file.getPath().c_str());
-
-        std::vector<glm::vec3> positions;
-        std::vector<glm::vec3> normals;
-        std::vector<Vertex>    vertices;
-        std::vector<glm::vec2> uv_mapping;
-
-        Material               material;
-        bool                   has_material = false;
-
-        char material_file_buffer[1024];
-        
-        glm::vec3 container;
-        u32 fa,  fb,  fc,  fd;
-        u32 fna, fnb, fnc, fnd;
-        u32 fta, ftb, ftc, ftd;
-
-        float furthest_vertex_value = 0.0f;
+        //gpu layout of meshes loaded from now on
+        VertexFormat g_vertex_format { VertexFormat::Float };
 
-        auto normalize_mesh = [&](std::vector<Vertex>& vertices)
+        /**
+         * gl enum of the attribute type
+         */
+        constexpr GLenum glAttributeType(AttributeType type)
         {
-            if (vertices.size() == 0)
-                return;
-
-            glm::vec3 center;
-
-            glm::vec3 mesh_max = glm::vec3(-std::numeric_limits<float>::infinity());
-            glm::vec3 mesh_min = glm::vec3( std::numeric_limits<float>::infinity());
-            //find the center of the model
-            for (auto& vertex : vertices)
-            {
-                if (vertex.pos.x > mesh_max.x) { mesh_max.x = vertex.pos.x; }
-                if (vertex.pos.y > mesh_max.y) { mesh_max.y = vertex.pos.y; }
-                if (vertex.pos.z > mesh_max.z) { mesh_max.z = vertex.pos.z; }
-
-                if (vertex.pos.x < mesh_min.x) { mesh_min.x = vertex.pos.x; }
-                if (vertex.pos.y < mesh_min.y) { mesh_min.y = vertex.pos.y; }
-                if (vertex.pos.z < mesh_min.z) { mesh_min.z = vertex.pos.z; }
-            }
-            center = mesh_min + (mesh_max - mesh_min) / 2.0f;
-
-            //move the whole model to 0, 0, 0 and find the furthest vertex from the center
-            u32   max_index = 0;
-            float max_value = 0;
-            for (size_t i = 0; i < vertices.size(); i++)
+            switch (type)
             {
-                vertices[i].pos -= center;
-
-                if (fabs(vertices[i].pos.x) > max_value) { max_value = fabs(vertices[i].pos.x); max_index = i; continue; }
-                if (fabs(vertices[i].pos.y) > max_value) { max_value = fabs(vertices[i].pos.y); max_index = i; continue; }
-                if (fabs(vertices[i].pos.z) > max_value) { max_value = fabs(vertices[i].pos.z); max_index = i; continue; }
+                case AttributeType::Short:     return GL_SHORT;
+                case AttributeType::HalfFloat: return GL_HALF_FLOAT;
+                default:                       return GL_FLOAT;
             }
+        }
 
+        /**
+         * convert vertices into the layout and copy them into the bound vertex buffer, return size of the buffer
+         */
+        template<typename Layout>
+        u64 uploadVertices(const std::vector<Vertex>& vertices)
+        {
+            std::vector<typename Layout::Type> converted;
+            converted.reserve(vertices.size());
 
-            //check for bullshit
-            if (max_value == 0)
+            for (const Vertex& vertex : vertices)
             {
-                return;
+                converted.push_back(Layout::pack(vertex));
             }
 
-            float size_delta = (0.5f / max_value);
+            glBufferData(GL_ARRAY_BUFFER, converted.size() * sizeof(typename Layout::Type), converted.data(), GL_STATIC_DRAW);
 
-            for (auto& vertex : vertices)
-            {
-                vertex.pos = vertex.pos * size_delta;
-                float vertex_delta = glm::dot(vertex.pos, vertex.pos);
-                if(vertex_delta > furthest_vertex_value)
-                {
-                    furthest_vertex_value = vertex_delta;
-                }
-            }
-        };
+            return converted.size() * sizeof(typename Layout::Type);
+        }
 
-        auto parse_material = [&](File& input_file)
+        /**
+         * point the shader attribute at the data of the semantic, the pointer setup is generated from the layout
+         */
+        template<VertexSemantic Semantic>
+        void bindVertexAttribute(const Vertices* vertices, u32 attribute_index)
         {
-            std::vector<u8> buffer = input_file.read();
-            std::string     line;
+            vertices->attributes[static_cast<u32>(Semantic)] = static_cast<s32>(attribute_index);
 
-            glm::vec3 container;
+            glBindVertexArray(vertices->vao);
+            glBindBuffer(GL_ARRAY_BUFFER, vertices->vbo);
 
-            char diffuse_map_file[1024];
-
-            for (u32 i = 0; i < buffer.size(); i++)
-            {
-                if(buffer[i] == '\n')
-                {
-                    if (line.size() > 2)
-                    {
-                        if (line[0] == 'K')
-                        {
-                            if(line[1] == 'a')
-                            {
-                                if (std::sscanf(reinterpret_cast<char*>(&line[0]), "Ka %f %f %f", &container.x, &container.y, &container.z) == 3)
-                                {
-                                    has_material = true;
-                                    material.ambient = container;
-                                }
-                            }
-                            else if(line[1] == 'd')
-                            {
-                                if (std::sscanf(reinterpret_cast<char*>(&line[0]), "Kd %f %f %f", &container.x, &container.y, &container.z) == 3)
-                                {
-                                    has_material = true;
-                                    material.diffuse = container;
-                                }
-                            }
-                            else if(line[1] == 's')
-                            {
-                                if (std::sscanf(reinterpret_cast<char*>(&line[0]), "Ks %f %f %f", &container.x, &container.y, &container.z) == 3)
-                                {
-                                    has_material = true;
-                                    material.specular = container;
-                                }
-                            }
-                        }
-                        else if (line[0] == 'm')
-                        {
-                            if (std::sscanf(reinterpret_cast<char*>(&line[0]), "map_Kd %s1023", diffuse_map_file) == 1)
-                            {
-                                has_material = true;
-                                //TODO: this shouldnt be hard string
-                                material.diffuse_mapping_texture.init(std::string("data/objects/") + diffuse_map_file);
-                            }
-                        }
-                    }
-                    line.clear();
-                }
-                else
+            visitLayout(vertices->format, vertices->has_uv, [&](auto layout)
                 {
-                    line += buffer[i];
-                }
-            }
-        };
-        
-        std::vector<u8> buffer = input_file.read();
-        std::string     line;
+                    using Layout = decltype(layout);
+                    constexpr const VertexAttribute* attribute = findAttribute<Layout>(Semantic);
 
-        u32 faces = 0;
-        
-        for(u32 i = 0; i < buffer.size(); i++)
-        {
-            if(buffer[i] == '\n')
-            {
-                if (line.size() > 0)
-                {
-                    // parse vertex
-                    if(line[0] == 'v')
-                    {
-                        // parse vertex position
-                        if(line[1] == ' ')
-                        {
-                            if(std::sscanf(reinterpret_cast<char*>(&line[0]), "v %f %f %f", &container.x, &container.y, &container.z) == 3)
-                            {
-                                positions.push_back(container);
-                            }
-                            else
-                            {
-                                std::printf("Mesh::cacheLoadingFunction() warning: unknown data: %s\n", line.c_str());
-                            }
-                        }
-                        // parse vertex normal
-                        else if(line[1] == 'n')
-                        {
-                            if(std::sscanf(reinterpret_cast<char*>(&line[0]), "vn %f %f %f", &container.x, &container.y, &container.z) == 3)
-                            {
-                                normals.push_back(container);
-                            }
-                            else
-                            {
-                                std::printf("Mesh::cacheLoadingFunction() warning: unknown data: %s\n", line.c_str());
-                            }
-                        }
-                        // parse vertex uv mapping
-                        else if (line[1] == 't')
-                        {
-                            if (std::sscanf(reinterpret_cast<char*>(&line[0]), "vt %f %f", &container.x, &container.y) == 2)
-                            {
-                                uv_mapping.emplace_back(container.x, container.y);
-                            }
-                            else
-                            {
-                                std::printf("Mesh::cacheLoadingFunction() warning: unknown data: %s\n", line.c_str());
-                            }
-                        }
-                    }
-                    // parse face
-                    else if(line[0] == 'f')
+                    if constexpr (attribute != nullptr)
                     {
-                        // parse triangles
-                        if(std::count(line.begin(), line.end(), ' ') == 3)
-                        {
-                            if(std::sscanf(reinterpret_cast<char*>(&line[0]), "f %u//%u %u//%u %u//%u", &fa, &fna, &fb, &fnb, &fc, &fnc) == 6)
-                            {
-                                vertices.emplace_back(positions[fa - 1], normals[fna - 1]);
-                                vertices.emplace_back(positions[fb - 1], normals[fnb - 1]);
-                                vertices.emplace_back(positions[fc - 1], normals[fnc - 1]);
-
-                                faces++;
-                            }
-                            else
-                            {
-                                if (std::sscanf(reinterpret_cast<char*>(&line[0]), "f %u/%u/%u %u/%u/%u %u/%u/%u", &fa, &fta, &fna, &fb, &ftb, &fnb, &fc, &ftc, &fnc) == 9)
-                                {
-                                    vertices.emplace_back(positions[fa - 1], normals[fna - 1], uv_mapping[fta - 1]);
-                                    vertices.emplace_back(positions[fb - 1], normals[fnb - 1], uv_mapping[ftb - 1]);
-                                    vertices.emplace_back(positions[fc - 1], normals[fnc - 1], uv_mapping[ftc - 1]);
-
-                                    faces++;
-                                }
-                                else
-                                {
-                                    std::printf("Mesh::cacheLoadingFunction() warning: unknown data: %s\n", line.c_str());
-                                    //TODO: warning?
-                                }
-                            }
-                        }
-                        // parse quads
-                        else
-                        {
-                            if(std::sscanf(reinterpret_cast<char*>(&line[0]), "f %u//%u %u//%u %u//%u %u//%u", &fa, &fna, &fb, &fnb, &fc, &fnc, &fd, &fnd) == 8)
-                            {
-                                vertices.emplace_back(positions[fa - 1], normals[fna - 1]);
-                                vertices.emplace_back(positions[fb - 1], normals[fnb - 1]);
-                                vertices.emplace_back(positions[fc - 1], normals[fnc - 1]);
-                                    
-                                vertices.emplace_back(positions[fa - 1], normals[fna - 1]);
-                                vertices.emplace_back(positions[fc - 1], normals[fnc - 1]);
-                                vertices.emplace_back(positions[fd - 1], normals[fnd - 1]);
-
-                                faces++; faces++;
-                            }
-                            else
-                            {
-                                if (std::sscanf(reinterpret_cast<char*>(&line[0]), "f %u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u", &fa, &fta, &fna, &fb, &ftb, &fnb, &fc, &ftc, &fnc, &fd, &ftd, &fnd) == 12)
-                                {
-                                    vertices.emplace_back(positions[fa - 1], normals[fna - 1], uv_mapping[fta - 1]);
-                                    vertices.emplace_back(positions[fb - 1], normals[fnb - 1], uv_mapping[ftb - 1]);
-                                    vertices.emplace_back(positions[fc - 1], normals[fnc - 1], uv_mapping[ftc - 1]);
-
-                                    vertices.emplace_back(positions[fa - 1], normals[fna - 1], uv_mapping[fta - 1]);
-                                    vertices.emplace_back(positions[fc - 1], normals[fnc - 1], uv_mapping[ftc - 1]);
-                                    vertices.emplace_back(positions[fd - 1], normals[fnd - 1], uv_mapping[ftd - 1]);
-
-                                    faces++; faces++;
-                                }
-                                else
-                                {
-                                    std::printf("Mesh::cacheLoadingFunction() warning: unknown data: %s\n", line.c_str());
-                                }
-                            }
-                        }
+                        glEnableVertexAttribArray(attribute_index);
+                        glVertexAttribPointer(attribute_index, attribute->count, glAttributeType(attribute->type), attribute->normalized ? GL_TRUE : GL_FALSE,
+                                              sizeof(typename Layout::Type), reinterpret_cast<void*>(static_cast<uintptr_t>(attribute->offset)));
                     }
-                    // skip comment and nonsence sized lines
-                    else if (line[0] == '#' || line.size() < 3)
+                    else
                     {
-                        (void)0;
+                        //the shader reads zeros like it did when the data was stored
+                        glDisableVertexAttribArray(attribute_index);
+                        glVertexAttrib4f(attribute_index, 0.0f, 0.0f, 0.0f, 1.0f);
                     }
-                    // parse material file
-                    else if (line[0] == 'm')
-                    {
-                        if(std::sscanf(reinterpret_cast<char*>(&line[0]), "mtllib %1023s", material_file_buffer) == 1)
-                        {
-                            File material(input_file.getFolder() + "/" + material_file_buffer);
-
-                            if(material.opened())
-                            {
-                                parse_material(material);
-                                material.close();
-                            }
-                            else
-                            {
-                                std::printf("Mesh::cacheLoadingFunction() warning: file cannot be opened: %s\n", material_file_buffer);
-                            }
-                        }
-                        else
-                        {
-                            std::printf("Mesh::cacheLoadingFunction() warning: unknown data: %s\n", line.c_str());
-                        }
-                    }
-                }
+                });
+
+            glBindVertexArray(0);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+    }
+
+    /**
+     * decode vertices from file on the loading workers, the cooked mesh is used while it is newer than the source
+     */
+    MeshData meshCacheDecodingFunction(File& input_file)
+    {
+        const std::string& path = input_file.getPath();
+
+        MeshData data;
 
-                line.clear();
+        if (std::filesystem::path(path).extension() == MeshFile::Extension)
+        {
+            data = MeshFile::loadCooked(path);
+        }
+        else if (MeshFile::cookedUpToDate(path))
+        {
+            try
+            {
+                data = MeshFile::loadCooked(MeshFile::cookedPath(path));
             }
-            else
+            catch (const std::runtime_error& error)
             {
-                line += buffer[i];
+                std::printf("Mesh() warning: %s\n", error.what());
+                data = MeshFile::loadObj(input_file);
             }
         }
-
-        if (vertices.size() == 0)
+        else
         {
-            throw std::runtime_error("Mesh::load() error: no data in .obj file");
+            data = MeshFile::loadObj(input_file);
         }
 
-        normalize_mesh(vertices);
+        return data;
+    }
 
-        // create vao and vbo
+    /**
+     * create vao, vbo and ebo on the gl thread and move the decoded data into them
+     */
+    Vertices meshCacheUploadFunction(MeshData& data)
+    {
         Vertices result;
-        result.furthest_vertex_value = std::sqrt(furthest_vertex_value);
-        result.size                  = vertices.size();
-        result.partitions.resize(DivisionFactor * DivisionFactor * DivisionFactor);
-
-        // divide the mesh into subspaces
-        for (u32 i = 0; i < vertices.size(); i++)
-        {
-            glm::vec3 translated_pos = (vertices[i].pos + 1.0f) / 2.0f;
-
-            u32 x = static_cast<u32>(translated_pos.x * DivisionFactor); if (x == DivisionFactor) { x = DivisionFactor - 1; }
-            u32 y = static_cast<u32>(translated_pos.y * DivisionFactor); if (y == DivisionFactor) { y = DivisionFactor - 1; }
-            u32 z = static_cast<u32>(translated_pos.z * DivisionFactor); if (z == DivisionFactor) { z = DivisionFactor - 1; }
+        result.furthest_vertex_value = data.furthest_vertex_value;
+        result.size                  = data.indices.size();
+        result.collision             = std::move(data.collision);
+        result.hull                  = std::move(data.hull);
 
-            result.partitions[x + DivisionFactor * (y + DivisionFactor * z)].push_back(i);
-        }
-
-        for (auto& v : result.partitions)
-        {
-            std::printf("Mesh() log: partition: %u\n", v.size());
-        }
-        
         glGenVertexArrays(1, &result.vao);
         glGenBuffers(1, &result.vbo);
+        glGenBuffers(1, &result.ebo);
         glBindVertexArray(result.vao);
 
         glBindBuffer(GL_ARRAY_BUFFER, result.vbo);
 
-        // copy vertex data
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+        // copy vertex data, the cpu copy keeps floats
+        result.format = g_vertex_format;
+        result.has_uv = data.has_uv;
+
+        visitLayout(result.format, result.has_uv, [&](auto layout)
+            {
+                result.gpu_bytes = uploadVertices<decltype(layout)>(data.vertices);
+            });
+
+        // copy index data of all lods, the binding is stored in the vao so it stays bound until the vao is unbound
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, result.ebo);
+
+        std::vector<u32> all_indices(data.indices);
+        all_indices.insert(all_indices.end(), data.lod_indices.begin(), data.lod_indices.end());
+
+        if (data.vertices.size() <= std::numeric_limits<u16>::max() + 1u)
+        {
+            std::vector<u16> short_indices(all_indices.begin(), all_indices.end());
+
+            result.index_type = GL_UNSIGNED_SHORT;
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, short_indices.size() * sizeof(u16), short_indices.data(), GL_STATIC_DRAW);
+            result.gpu_bytes += short_indices.size() * sizeof(u16);
+        }
+        else
+        {
+            result.index_type = GL_UNSIGNED_INT;
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, all_indices.size() * sizeof(u32), all_indices.data(), GL_STATIC_DRAW);
+            result.gpu_bytes += all_indices.size() * sizeof(u32);
+        }
 
         glBindVertexArray(0);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-        result.data         = std::move(vertices);
-        result.has_material = has_material;
+        result.data         = std::move(data.vertices);
+        result.indices      = std::move(data.indices);
+        result.lods         = std::move(data.lods);
+        result.has_material = data.has_material;
         if(result.has_material)
         { 
-            result.material = std::move(material);
+            result.material = Material(data.diffuse, data.ambient, data.specular, 0.0f);
+
+            if (data.diffuse_map.empty() == false)
+            {
+                result.material.diffuse_mapping_texture.init(data.diffuse_map);
+            }
         }
         
-        std::printf("Mesh() log: %s - loaded %u vertices\n", input_file.getPath().c_str(), result.data.size());
+        std::printf("Mesh() log: uploaded %u vertices, %u indices\n", static_cast<u32>(result.data.size()), static_cast<u32>(result.indices.size()));
 
         return result;
     }
@@ -383,6 +214,7 @@ namespace Engine3D
     void meshCacheClearFunction(Vertices& object)
     {
         glDeleteBuffers(1, &object.vbo);
+        glDeleteBuffers(1, &object.ebo);
 #ifdef APPLE
         glDeleteVertexArraysAPPLE(1, &object.vao);
 #else
@@ -391,15 +223,71 @@ namespace Engine3D
     }
     
     /**
-     * cache implementation
+     * get bytes taken by the buffers and by the data kept in ram
      */
-    Cache<Vertices> g_vertices_cache(meshCacheLoadingFunction, meshCacheClearFunction);
+    u64 meshCacheSizeFunction(const Vertices& object)
+    {
+        const CollisionMesh& collision = object.collision;
+        const ConvexHull&    hull      = object.hull;
+
+        return object.gpu_bytes +
+               object.data.size()                * sizeof(Vertex) +
+               object.indices.size()             * sizeof(u32) +
+               object.lods.size()                * sizeof(MeshLod) +
+               collision.positions.size()        * sizeof(glm::vec3) +
+               collision.indices.size()          * sizeof(u32) +
+               collision.bvh.nodes().size()      * sizeof(BoundingVolumeHierarchy::Node) +
+               collision.bvh.triangles().size()  * sizeof(u32) +
+               hull.points().size()              * sizeof(glm::vec3) +
+               hull.faces().size()               * sizeof(ConvexHull::Face) +
+               hull.normals().size()             * sizeof(glm::vec3) +
+               hull.edges().size()               * sizeof(glm::vec3) +
+               hull.adjacencyOffsets().size()    * sizeof(u32) +
+               hull.adjacency().size()           * sizeof(u32);
+    }
     
-    std::vector<Vertex> simplify(Vertices& v, u32 level)
+    /**
+     * free the vertices kept in ram
+     */
+    void discardVertexData(Vertices& vertices)
+    {
+        vertices.discarded = true;
+        vertices.data.clear();
+        vertices.data.shrink_to_fit();
+        vertices.indices.clear();
+        vertices.indices.shrink_to_fit();
+    }
+
+    /**
+     * bind the attributes of the reloaded mesh like the previous one was bound
+     */
+    void meshCacheReloadFunction(const Vertices& previous, Vertices& reloaded)
     {
-        return {};
+        if (previous.attributes[static_cast<u32>(VertexSemantic::Position)] >= 0)
+        {
+            bindVertexAttribute<VertexSemantic::Position>(&reloaded, previous.attributes[static_cast<u32>(VertexSemantic::Position)]);
+        }
+        if (previous.attributes[static_cast<u32>(VertexSemantic::Normal)] >= 0)
+        {
+            bindVertexAttribute<VertexSemantic::Normal>(&reloaded, previous.attributes[static_cast<u32>(VertexSemantic::Normal)]);
+        }
+        if (previous.attributes[static_cast<u32>(VertexSemantic::UV)] >= 0)
+        {
+            bindVertexAttribute<VertexSemantic::UV>(&reloaded, previous.attributes[static_cast<u32>(VertexSemantic::UV)]);
+        }
+
+        if (previous.discarded)
+        {
+            discardVertexData(reloaded);
+        }
     }
 
+    /**
+     * cache implementation
+     */
+    Cache<Vertices, MeshData> g_vertices_cache("meshes", meshCacheDecodingFunction, meshCacheUploadFunction, meshCacheClearFunction, meshCacheSizeFunction,
+                                               meshCacheReloadFunction, MeshFile::dependencies);
+    
     /**
      * destructor
      */
@@ -413,14 +301,12 @@ namespace Engine3D
      */
     void Mesh::init(const std::string&& id)
     {
-        m_vertices_id = id;
-        g_vertices_cache.add(id);
+        m_vertices = g_vertices_cache.get(id);
     }
 
     void Mesh::init(const std::string& id)
     {
-        m_vertices_id = id;
-        g_vertices_cache.add(id);
+        m_vertices = g_vertices_cache.get(id);
     }
     
     /**
@@ -429,32 +315,73 @@ namespace Engine3D
      */
     bool Mesh::empty() const
     {
-        return m_vertices_id == "";
+        return m_vertices.valid() == false;
+    }
+
+    /**
+     * check if the mesh is loaded and uploaded
+     */
+    bool Mesh::ready() const
+    {
+        return g_vertices_cache.peek(m_vertices) != nullptr;
+    }
+
+    /**
+     * get number of times the mesh was reloaded
+     */
+    u32 Mesh::version() const
+    {
+        return g_vertices_cache.version(m_vertices);
     }
         
     /**
      * draw mesh
      */
     void Mesh::draw()
+    {
+        draw(std::numeric_limits<float>::max());
+    }
+
+    /**
+     * draw the coarsest lod whose error stays under LodPixelError on screen
+     */
+    void Mesh::draw(float screen_size)
     {
         if(empty())
         {
             return;
         }
 
-        const Vertices* data = g_vertices_cache.peek(m_vertices_id);
+        const Vertices* data = g_vertices_cache.peek(m_vertices);
 
+        //still loading
         if (data == nullptr)
         {
-            data = g_vertices_cache.get(m_vertices_id);
+            return;
+        }
+
+        //the bounding box is 2 * furthest_vertex_value wide in mesh space
+        float   pixels_per_unit = screen_size / (2.0f * data->furthest_vertex_value);
+        MeshLod lod             = data->lods.empty() ? MeshLod{ 0, data->size, 0.0f } : data->lods[0];
+
+        for (u32 i = 1; i < data->lods.size(); i++)
+        {
+            if (data->lods[i].error * pixels_per_unit > LodPixelError)
+            {
+                break;
+            }
+
+            lod = data->lods[i];
         }
+
+        u32 index_size = data->index_type == GL_UNSIGNED_SHORT ? sizeof(u16) : sizeof(u32);
         
 #ifdef APPLE
         glBindVertexArrayAPPLE(data->vao);
 #else
         glBindVertexArray(data->vao);
 #endif
-        glDrawArrays(GL_TRIANGLES, 0, data->size);
+        glDrawElements(GL_TRIANGLES, lod.index_count, data->index_type, reinterpret_cast<void*>(static_cast<uintptr_t>(lod.index_offset * index_size)));
         
 #ifdef APPLE
         glBindVertexArrayAPPLE(0);
@@ -464,48 +391,81 @@ namespace Engine3D
     }
 
     /**
-     * get vertices
+     * get unique vertices
      */
     const std::vector<Vertex>* Mesh::vertices()
     {
-        const Vertices* vertices = g_vertices_cache.peek(m_vertices_id);
-
-        if (vertices == nullptr)
-        {
-            vertices = g_vertices_cache.get(m_vertices_id);
-        }
+        const Vertices* vertices = g_vertices_cache.wait(m_vertices);
 
         return &(vertices->data);
     }
 
+    /**
+     * get triangle list
+     */
+    const std::vector<u32>* Mesh::indices()
+    {
+        const Vertices* vertices = g_vertices_cache.wait(m_vertices);
+
+        return &(vertices->indices);
+    }
+
     /**
      * get raw vertices
      */
     const Vertices* Mesh::rawVertices()
     {
-        const Vertices* vertices = g_vertices_cache.peek(m_vertices_id);
-
-        if(vertices == nullptr)
-        {
-            vertices = g_vertices_cache.get(m_vertices_id);
-        }
+        const Vertices* vertices = g_vertices_cache.wait(m_vertices);
 
         return vertices;
     }
 
+    /**
+     * get distance of the furthest vertex from the origin of the mesh
+     */
+    float Mesh::radius() const
+    {
+        const Vertices* vertices = g_vertices_cache.peek(m_vertices);
+
+        return vertices != nullptr ? vertices->furthest_vertex_value : 0.0f;
+    }
+
+    /**
+     * get simplified triangles the collisions are tested against in mesh space
+     */
+    const CollisionMesh& Mesh::collisionMesh()
+    {
+        const Vertices* vertices = g_vertices_cache.wait(m_vertices);
+
+        return vertices->collision;
+    }
+
+    /**
+     * get bounding volume hierarchy over the collision triangles in mesh space
+     */
+    const BoundingVolumeHierarchy& Mesh::bvh()
+    {
+        return collisionMesh().bvh;
+    }
+
+    /**
+     * get convex hull of the collision mesh in mesh space
+     */
+    const ConvexHull& Mesh::hull()
+    {
+        const Vertices* vertices = g_vertices_cache.wait(m_vertices);
+
+        return vertices->hull;
+    }
+
     /**
      * get material
      */
     const Material* Mesh::material()
     {
-        const Vertices* vertices = g_vertices_cache.peek(m_vertices_id);
-
-        if (vertices == nullptr)
-        {
-            vertices = g_vertices_cache.get(m_vertices_id);
-        }
+        const Vertices* vertices = g_vertices_cache.peek(m_vertices);
 
-        if(vertices->has_material)
+        if(vertices != nullptr && vertices->has_material)
         {
             return &vertices->material;
         }
@@ -516,37 +476,55 @@ namespace Engine3D
     }
 
     /**
-     * deletes the data saved in ram
+     * get layout of the vertices in the gpu buffer
      */
-    void Mesh::discardVertices()
+    VertexFormat Mesh::vertexFormat()
     {
-        Vertices* vertices = const_cast<Vertices*>(g_vertices_cache.peek(m_vertices_id));
+        const Vertices* vertices = g_vertices_cache.peek(m_vertices);
 
-        if (vertices != nullptr)
-        {
-            vertices->data.clear();
-        }
+        return vertices != nullptr ? vertices->format : g_vertex_format;
     }
 
     /**
-     * extract triangle from vertices
+     * set gpu layout of meshes loaded from now on
      */
-    Triangle Mesh::constructTriangle(u32 vert_index_start)
+    void Mesh::setVertexFormat(VertexFormat format)
     {
-        const Vertices* vertices = g_vertices_cache.peek(m_vertices_id);
-        if (vertices == nullptr)
-        {
-            vertices = g_vertices_cache.get(m_vertices_id);
-        }
+        g_vertex_format = format;
+    }
+
+    /**
+     * set bytes the loaded meshes may take before the unused ones are freed
+     */
+    void Mesh::setCacheBudget(u64 bytes)
+    {
+        g_vertices_cache.setBudget(bytes);
+    }
 
-        if (vert_index_start + 2 >= vertices->data.size())
+    /**
+     * deletes the vertices saved in ram
+     */
+    void Mesh::discardVertices()
+    {
+        //the collisions only use the simplified mesh and the hull, the gpu keeps the rest
+        g_vertices_cache.modify(m_vertices, discardVertexData);
+    }
+
+    /**
+     * extract triangle from the collision mesh, the start is a position in its indices
+     */
+    Triangle Mesh::constructTriangle(u32 index_start)
+    {
+        const CollisionMesh& collision = collisionMesh();
+
+        if (index_start + 2 >= collision.indices.size())
         {
             throw std::runtime_error("Mesh::constructTriangle() error: not enought vertices");
         }
 
-        return { vertices->data[vert_index_start + 0].pos, 
-                 vertices->data[vert_index_start + 1].pos,
-                 vertices->data[vert_index_start + 2].pos };
+        return { collision.positions[collision.indices[index_start + 0]],
+                 collision.positions[collision.indices[index_start + 1]],
+                 collision.positions[collision.indices[index_start + 2]] };
     }
     
     /**
@@ -559,64 +537,25 @@ namespace Engine3D
             return;
         }
         
-        g_vertices_cache.del(m_vertices_id);
+        g_vertices_cache.del(m_vertices);
     }
 
+    /**
+     * the attributes are stored in the vao, meshes still loading get them once they are uploaded
+     */
     void Mesh::bindVertexPositionWithShader(const Shader& shader, const char* attribute_name)
     {
-        const Vertices* vertices = (g_vertices_cache.peek(m_vertices_id));
-        if (vertices == nullptr)
-        {
-            vertices = (g_vertices_cache.get(m_vertices_id));
-        }
-
-        u32 attribute_index = shader.getAttributeIndex(attribute_name);
-
-        glBindVertexArray(vertices->vao);
-        glBindBuffer(GL_ARRAY_BUFFER, vertices->vbo);
-
-        glEnableVertexAttribArray(attribute_index);
-        glVertexAttribPointer(attribute_index, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
-
-        glBindVertexArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        u32 index = shader.getAttributeIndex(attribute_name);
+        g_vertices_cache.whenReady(m_vertices, [index](const Vertices& data) { bindVertexAttribute<VertexSemantic::Position>(&data, index); });
     }
     void Mesh::bindVertexNormalWithShader(const Shader& shader, const char* attribute_name)
     {
-        const Vertices* vertices = (g_vertices_cache.peek(m_vertices_id));
-        if (vertices == nullptr)
-        {
-            vertices = (g_vertices_cache.get(m_vertices_id));
-        }
-
-        u32 attribute_index = shader.getAttributeIndex(attribute_name);
-
-        glBindVertexArray(vertices->vao);
-        glBindBuffer(GL_ARRAY_BUFFER, vertices->vbo);
-
-        glEnableVertexAttribArray(attribute_index);
-        glVertexAttribPointer(attribute_index, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, nor));
-
-        glBindVertexArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        u32 index = shader.getAttributeIndex(attribute_name);
+        g_vertices_cache.whenReady(m_vertices, [index](const Vertices& data) { bindVertexAttribute<VertexSemantic::Normal>(&data, index); });
     }
     void Mesh::bindVertexUVWithShader(const Shader& shader, const char* attribute_name)
     {
-        const Vertices* vertices = (g_vertices_cache.peek(m_vertices_id));
-        if (vertices == nullptr)
-        {
-            vertices = (g_vertices_cache.get(m_vertices_id));
-        }
-
-        u32 attribute_index = shader.getAttributeIndex(attribute_name);
-
-        glBindVertexArray(vertices->vao);
-        glBindBuffer(GL_ARRAY_BUFFER, vertices->vbo);
-
-        glEnableVertexAttribArray(attribute_index);
-        glVertexAttribPointer(attribute_index, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
-
-        glBindVertexArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        u32 index = shader.getAttributeIndex(attribute_name);
+        g_vertices_cache.whenReady(m_vertices, [index](const Vertices& data) { bindVertexAttribute<VertexSemantic::UV>(&data, index); });
     }
 };
\ No newline at end of file
@@ -25,26 +25,12 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 #include "Texture.hpp"
 #include "Shapes.hpp"
 #include "Shader.hpp"
+#include "BoundingVolumeHierarchy.hpp"
+#include "ConvexHull.hpp"
+#include "VertexLayout.hpp"
 
 namespace Engine3D
 {
-    static constexpr Engine3D::u32 DivisionFactor = 2;
-
-    /**
-     * vertex structure
-     */
-    struct Vertex
-    {
-        Vertex() {}
-        Vertex(const glm::vec3& p_pos) : pos(p_pos) {}
-        Vertex(const glm::vec3& p_pos, const glm::vec3& p_nor) : pos(p_pos), nor(p_nor) {}
-        Vertex(const glm::vec3& p_pos, const glm::vec3& p_nor, const glm::vec2& p_uv) : pos(p_pos), nor(p_nor), uv(p_uv) {}
-
-        glm::vec3 pos { 0 };
-        glm::vec3 nor { 1, 0, 0 };
-        glm::vec2 uv  { 0, 0 };
-    };
-
     /**
      * material
      */
@@ -62,19 +48,51 @@ namespace Engine3D
         Texture   diffuse_mapping_texture;
     };
 
+    /**
+     * level of detail, range of the index buffer drawn instead of the full mesh
+     */
+    struct MeshLod
+    {
+        u32   index_offset { 0 };
+        u32   index_count  { 0 };
+        float error        { 0 }; //rms distance of the simplified surface from the full one in mesh space
+    };
+
+    /**
+     * simplified triangles of the mesh the collisions are tested against, positions only
+     */
+    struct CollisionMesh
+    {
+        std::vector<glm::vec3>  positions;
+        std::vector<u32>        indices; //triangle list, triangle i is made of positions[indices[3 * i + 0 .. 2]]
+        BoundingVolumeHierarchy bvh;     //triangle i starts at index 3 * i
+    };
+
     /**
      * GPU + CPU vertices
      */
     struct Vertices
     {
-        u32 size;
+        u32 size;       //number of indices drawn
         u32 vao;
         u32 vbo;
+        u32 ebo;
+        u32 index_type; //GL_UNSIGNED_SHORT if all vertices fit, GL_UNSIGNED_INT otherwise
+        u64 gpu_bytes;  //size of the vertex and index buffers
+        VertexFormat format;
+        bool         has_uv; //meshes without uv mapping don't store them on the gpu
         Material material;
         bool     has_material;
         std::vector<Vertex> data;
-        std::vector<std::vector<u32>> partitions;
+        std::vector<u32>    indices;
+        std::vector<MeshLod> lods; //lods[0] is the full mesh, the coarser ones follow it in the index buffer
+        CollisionMesh collision; //stays in ram when the vertices are discarded
+        ConvexHull    hull;
         float   furthest_vertex_value;
+
+        //state set up after the upload, carried over when the mesh file is reloaded
+        mutable s32 attributes[3] { -1, -1, -1 }; //shader attribute bound to each VertexSemantic, -1 if none
+        bool        discarded     { false };
     };
 
     /**
@@ -96,7 +114,7 @@ namespace Engine3D
        ~Mesh();
         
         /**
-         * load verties into memory
+         * load verties into memory, the mesh is decoded on the loading workers and uploaded during AssetLoader::update()
          */
         void init(const char* id) { init(std::string(id)); }
         void init(const std::string&& id);
@@ -107,11 +125,33 @@ namespace Engine3D
          * if it hasn't been initialized
          */
         bool empty() const;
+
+        /**
+         * check if the mesh is loaded, it isn't drawn until then and the functions returning its data wait for it
+         */
+        bool ready() const;
+
+        /**
+         * get number of times the mesh was reloaded, state built from its data is stale once it changes
+         */
+        u32 version() const;
         
         /**
          * draw mesh
          */
         void draw();
+
+        /**
+         * draw the coarsest lod whose error stays under LodPixelError on screen
+         *
+         * \arg screen_size - size of the mesh bounding box on screen in pixels
+         */
+        void draw(float screen_size);
+
+        /**
+         * error in pixels allowed for the lods, the error is a rms distance so single vertices may move a few pixels
+         */
+        constexpr static float LodPixelError = 1.0f;
         
         /**
          * deallocate vertices
@@ -119,24 +159,45 @@ namespace Engine3D
         void clear();
 
         /**
-         * get vertices
+         * get unique vertices
          */
         const std::vector<Vertex>* vertices();
 
         /**
-         * deletes the data saved in ram
+         * get triangle list, triangle i is made of vertices()[indices()[3 * i + 0 .. 2]]
+         */
+        const std::vector<u32>* indices();
+
+        /**
+         * deletes the vertices saved in ram once the mesh is loaded, the collision mesh and the hull are kept,
+         * the vertices are shared, so every mesh loaded from the same file loses them
          */
         void discardVertices();
 
         /**
-         * get material
+         * get material, nullptr while the mesh is loading
          */
         const Material* material();
 
         /**
-         * extract triangle from vertices
+         * get layout of the vertices in the gpu buffer, shaders decode the normal if it is packed
+         */
+        VertexFormat vertexFormat();
+
+        /**
+         * set gpu layout of meshes loaded from now on
+         */
+        static void setVertexFormat(VertexFormat format);
+
+        /**
+         * set bytes the loaded meshes may take, meshes no longer used are kept for reuse until the budget runs out
+         */
+        static void setCacheBudget(u64 bytes);
+
+        /**
+         * extract triangle from the collision mesh, the start is a position in its indices
          */
-        Triangle constructTriangle(u32 vert_index_start);
+        Triangle constructTriangle(u32 index_start);
 
 
         void bindVertexPositionWithShader(const Shader& shader, const char* attribute_name);
@@ -147,12 +208,34 @@ namespace Engine3D
          * get raw vertices
          */
         const Vertices* rawVertices();
+
+        /**
+         * get distance of the furthest vertex from the origin of the mesh, doesn't wait for the mesh,
+         * 0 while it is loading or if the loading failed
+         */
+        float radius() const;
+
+        /**
+         * get simplified triangles the collisions are tested against in mesh space
+         */
+        const CollisionMesh& collisionMesh();
+
+        /**
+         * get bounding volume hierarchy over the collision triangles in mesh space,
+         * triangle i starts at index 3 * i of the collision mesh
+         */
+        const BoundingVolumeHierarchy& bvh();
+
+        /**
+         * get convex hull of the collision mesh in mesh space
+         */
+        const ConvexHull& hull();
         
     private:
 
         /**
-         * vertices management
+         * vertices management, the path is looked up once by init()
          */
-        std::string m_vertices_id { "" };
+        CacheHandle<Vertices> m_vertices;
     };
 };
\ No newline at end of file
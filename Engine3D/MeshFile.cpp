@@ -0,0 +1,995 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "MeshFile.hpp"
+#include "MeshOptimizer.hpp"
+
+#include <limits>
+#include <numeric>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <string_view>
+#include <stdexcept>
+#include <filesystem>
+#include <type_traits>
+#include <unordered_map>
+
+namespace Engine3D
+{
+    namespace
+    {
+        //lods including the full mesh, a coarser level is built only while it keeps the minimum of triangles
+        constexpr u32 MaxLods         = 4;
+        constexpr u32 MinLodTriangles = 32;
+
+        //error of the lod picked as the collision mesh in mesh space, where the mesh spans one unit
+        constexpr float CollisionMaxError = 0.01f;
+
+        /**
+         * cursor over text loaded from a file, words and numbers are read in place
+         */
+        struct TextCursor
+        {
+            TextCursor(const std::vector<u8>& buffer) : pos(reinterpret_cast<const char*>(buffer.data())), end(pos + buffer.size()) {}
+
+            const char* pos;
+            const char* end;
+
+            bool done() const { return pos >= end; }
+
+            void skipSpaces()
+            {
+                while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r'))
+                {
+                    pos++;
+                }
+            }
+
+            /**
+             * move to the start of the next line
+             */
+            void nextLine()
+            {
+                const char* line_end = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+                pos = line_end != nullptr ? line_end + 1 : end;
+            }
+
+            /**
+             * check if only spaces or a comment are left on the line
+             */
+            bool lineEnd()
+            {
+                skipSpaces();
+                return pos >= end || *pos == '\n' || *pos == '#';
+            }
+
+            /**
+             * get the rest of the line, used for warnings
+             */
+            std::string_view rest() const
+            {
+                const char* line_end = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+                return std::string_view(pos, (line_end != nullptr ? line_end : end) - pos);
+            }
+
+            std::string_view word()
+            {
+                skipSpaces();
+
+                const char* start = pos;
+
+                while (pos < end && *pos != ' ' && *pos != '\t' && *pos != '\r' && *pos != '\n')
+                {
+                    pos++;
+                }
+
+                return std::string_view(start, pos - start);
+            }
+
+            template<typename T>
+            bool number(T& value)
+            {
+                skipSpaces();
+
+                //from_chars doesn't take the plus sign
+                if (pos < end && *pos == '+')
+                {
+                    pos++;
+                }
+
+                auto [ptr, ec] = std::from_chars(pos, end, value);
+
+                if (ec != std::errc())
+                {
+                    return false;
+                }
+
+                pos = ptr;
+                return true;
+            }
+
+            bool skip(char c)
+            {
+                if (pos < end && *pos == c)
+                {
+                    pos++;
+                    return true;
+                }
+                return false;
+            }
+        };
+
+        /**
+         * hash and compare values bit by bit, only exact copies are welded
+         */
+        template<typename T>
+        struct BitwiseHash
+        {
+            size_t operator()(const T& value) const
+            {
+                static_assert(sizeof(T) % sizeof(u32) == 0, "values are hashed as 32 bit words");
+
+                u32 words[sizeof(T) / sizeof(u32)];
+                std::memcpy(words, &value, sizeof(T));
+
+                u64 hash = 14695981039346656037ull;
+                for (u32 word : words)
+                {
+                    hash = (hash ^ word) * 1099511628211ull;
+                }
+
+                return static_cast<size_t>(hash);
+            }
+        };
+
+        template<typename T>
+        struct BitwiseEqual
+        {
+            bool operator()(const T& a, const T& b) const
+            {
+                return std::memcmp(&a, &b, sizeof(T)) == 0;
+            }
+        };
+
+        /**
+         * replace triangle soup with unique vertices and a triangle list of indices into them
+         */
+        void weldVertices(std::vector<Vertex>& vertices, std::vector<u32>& indices)
+        {
+            std::unordered_map<Vertex, u32, BitwiseHash<Vertex>, BitwiseEqual<Vertex>> unique;
+            unique.reserve(vertices.size());
+
+            std::vector<Vertex> welded;
+            welded.reserve(vertices.size());
+
+            indices.resize(vertices.size());
+
+            for (u32 i = 0; i < vertices.size(); i++)
+            {
+                auto [it, inserted] = unique.emplace(vertices[i], static_cast<u32>(welded.size()));
+
+                if (inserted)
+                {
+                    welded.push_back(vertices[i]);
+                }
+
+                indices[i] = it->second;
+            }
+
+            welded.shrink_to_fit();
+            vertices = std::move(welded);
+        }
+
+        /**
+         * parse .obj file into a triangle soup, the material and uv flag are stored in the result
+         */
+        std::vector<Vertex> parseObj(File& input_file, MeshData& result)
+        {
+            std::vector<glm::vec3> positions;
+            std::vector<glm::vec3> normals;
+            std::vector<Vertex>    vertices;
+            std::vector<glm::vec2> uv_mapping;
+
+            auto parse_material = [&](File& input_file)
+            {
+                std::vector<u8> buffer = input_file.read();
+                TextCursor      text(buffer);
+
+                glm::vec3 container;
+
+                for (; text.done() == false; text.nextLine())
+                {
+                    std::string_view keyword = text.word();
+
+                    if (keyword == "Ka" || keyword == "Kd" || keyword == "Ks")
+                    {
+                        if (text.number(container.x) && text.number(container.y) && text.number(container.z))
+                        {
+                            result.has_material = true;
+
+                            if      (keyword == "Ka") { result.ambient  = container; }
+                            else if (keyword == "Kd") { result.diffuse  = container; }
+                            else                      { result.specular = container; }
+                        }
+                    }
+                    else if (keyword == "map_Kd")
+                    {
+                        std::string_view diffuse_map_file = text.word();
+
+                        if (diffuse_map_file.empty() == false)
+                        {
+                            result.has_material = true;
+                            //TODO: this shouldnt be hard string
+                            result.diffuse_map = std::string("data/objects/") + std::string(diffuse_map_file);
+                        }
+                    }
+                }
+            };
+
+            //turn 1 based or negative relative index into an index into the elements
+            auto resolve = [](s32 index, size_t count, u32& result)
+            {
+                s64 resolved = index < 0 ? static_cast<s64>(count) + index : static_cast<s64>(index) - 1;
+
+                if (resolved < 0 || resolved >= static_cast<s64>(count))
+                {
+                    return false;
+                }
+
+                result = static_cast<u32>(resolved);
+                return true;
+            };
+
+            //corner of a face - v, v/vt, v//vn or v/vt/vn
+            struct Corner
+            {
+                u32  position   { 0 };
+                u32  uv         { 0 };
+                u32  normal     { 0 };
+                bool has_uv     { false };
+                bool has_normal { false };
+            };
+
+            std::vector<u8> buffer = input_file.read();
+            TextCursor      text(buffer);
+
+            auto parse_corner = [&](Corner& corner)
+            {
+                s32 index = 0;
+
+                corner.has_uv     = false;
+                corner.has_normal = false;
+
+                if (!text.number(index) || !resolve(index, positions.size(), corner.position))
+                {
+                    return false;
+                }
+
+                if (!text.skip('/'))
+                {
+                    return true;
+                }
+
+                if (!text.skip('/'))
+                {
+                    if (!text.number(index) || !resolve(index, uv_mapping.size(), corner.uv))
+                    {
+                        return false;
+                    }
+
+                    corner.has_uv = true;
+                    result.has_uv = true;
+
+                    if (!text.skip('/'))
+                    {
+                        return true;
+                    }
+                }
+
+                if (!text.number(index) || !resolve(index, normals.size(), corner.normal))
+                {
+                    return false;
+                }
+
+                corner.has_normal = true;
+                return true;
+            };
+
+            auto add_triangle = [&](const Corner& a, const Corner& b, const Corner& c)
+            {
+                //corners without a normal get the flat one of the triangle
+                glm::vec3 flat_normal(1, 0, 0);
+
+                if (!a.has_normal || !b.has_normal || !c.has_normal)
+                {
+                    glm::vec3 normal = glm::cross(positions[b.position] - positions[a.position], positions[c.position] - positions[a.position]);
+
+                    if (glm::dot(normal, normal) > 0.0f)
+                    {
+                        flat_normal = glm::normalize(normal);
+                    }
+                }
+
+                for (const Corner* corner : { &a, &b, &c })
+                {
+                    vertices.emplace_back(positions[corner->position],
+                                          corner->has_normal ? normals[corner->normal]   : flat_normal,
+                                          corner->has_uv     ? uv_mapping[corner->uv]    : glm::vec2(0, 0));
+                }
+            };
+
+            glm::vec3 container;
+
+            for (; text.done() == false; text.nextLine())
+            {
+                std::string_view line    = text.rest();
+                std::string_view keyword = text.word();
+
+                // parse vertex position
+                if (keyword == "v")
+                {
+                    if (text.number(container.x) && text.number(container.y) && text.number(container.z))
+                    {
+                        positions.push_back(container);
+                    }
+                    else
+                    {
+                        std::printf("MeshFile::loadObj() warning: unknown data: %.*s\n", static_cast<int>(line.size()), line.data());
+                    }
+                }
+                // parse vertex normal
+                else if (keyword == "vn")
+                {
+                    if (text.number(container.x) && text.number(container.y) && text.number(container.z))
+                    {
+                        normals.push_back(container);
+                    }
+                    else
+                    {
+                        std::printf("MeshFile::loadObj() warning: unknown data: %.*s\n", static_cast<int>(line.size()), line.data());
+                    }
+                }
+                // parse vertex uv mapping
+                else if (keyword == "vt")
+                {
+                    if (text.number(container.x) && text.number(container.y))
+                    {
+                        uv_mapping.emplace_back(container.x, container.y);
+                    }
+                    else
+                    {
+                        std::printf("MeshFile::loadObj() warning: unknown data: %.*s\n", static_cast<int>(line.size()), line.data());
+                    }
+                }
+                // parse face, polygons are split into a fan around the first corner
+                else if (keyword == "f")
+                {
+                    Corner first;
+                    Corner previous;
+                    Corner current;
+                    u32    corners = 0;
+                    bool   valid   = true;
+
+                    while (text.lineEnd() == false)
+                    {
+                        if (!parse_corner(current))
+                        {
+                            valid = false;
+                            break;
+                        }
+
+                        if (corners == 0)
+                        {
+                            first = current;
+                        }
+                        else if (corners >= 2)
+                        {
+                            add_triangle(first, previous, current);
+                        }
+
+                        previous = current;
+                        corners++;
+                    }
+
+                    if (!valid || corners < 3)
+                    {
+                        std::printf("MeshFile::loadObj() warning: unknown data: %.*s\n", static_cast<int>(line.size()), line.data());
+                    }
+                }
+                // parse material file
+                else if (keyword == "mtllib")
+                {
+                    std::string_view material_file = text.word();
+
+                    if (material_file.empty())
+                    {
+                        std::printf("MeshFile::loadObj() warning: unknown data: %.*s\n", static_cast<int>(line.size()), line.data());
+                        continue;
+                    }
+
+                    //a missing material file is remembered too, the mesh changes once it is created
+                    result.material_files.emplace_back(material_file);
+
+                    File material(input_file.getFolder() + "/" + std::string(material_file));
+
+                    if(material.opened())
+                    {
+                        parse_material(material);
+                        material.close();
+                    }
+                    else
+                    {
+                        std::printf("MeshFile::loadObj() warning: file cannot be opened: %.*s\n", static_cast<int>(material_file.size()), material_file.data());
+                    }
+                }
+                // comments, groups, smoothing and material switches are skipped
+            }
+
+            if (vertices.size() == 0)
+            {
+                throw std::runtime_error("MeshFile::loadObj() error: no data in .obj file");
+            }
+
+            return vertices;
+        }
+
+        /**
+         * get the transform moving the mesh to the origin and scaling it into the box from -0.5 to 0.5,
+         * the collision mesh of a file is moved by the transform of its render mesh
+         */
+        void normalization(const std::vector<Vertex>& vertices, glm::vec3& center, float& size_delta)
+        {
+            center     = glm::vec3(0);
+            size_delta = 1.0f;
+
+            if (vertices.size() == 0)
+                return;
+
+            glm::vec3 mesh_max = glm::vec3(-std::numeric_limits<float>::infinity());
+            glm::vec3 mesh_min = glm::vec3( std::numeric_limits<float>::infinity());
+            //find the center of the model
+            for (auto& vertex : vertices)
+            {
+                mesh_max = glm::max(mesh_max, vertex.pos);
+                mesh_min = glm::min(mesh_min, vertex.pos);
+            }
+            center = mesh_min + (mesh_max - mesh_min) / 2.0f;
+
+            //find the coordinate furthest from the center
+            float max_value = 0;
+            for (auto& vertex : vertices)
+            {
+                glm::vec3 distance = glm::abs(vertex.pos - center);
+                max_value = std::max(max_value, std::max(distance.x, std::max(distance.y, distance.z)));
+            }
+
+            //check for bullshit
+            if (max_value == 0)
+            {
+                return;
+            }
+
+            size_delta = (0.5f / max_value);
+        }
+
+        /**
+         * build the collision mesh from a triangle list over the vertices, corners at the same position
+         * are merged so the proxy stays closed over the uv and normal seams of the render mesh
+         */
+        CollisionMesh buildCollisionMesh(const std::vector<Vertex>& vertices, const u32* indices, u32 index_count)
+        {
+            CollisionMesh result;
+
+            std::unordered_map<glm::vec3, u32, BitwiseHash<glm::vec3>, BitwiseEqual<glm::vec3>> unique;
+            std::vector<u32> remap(vertices.size(), std::numeric_limits<u32>::max());
+
+            result.indices.reserve(index_count);
+
+            for (u32 i = 0; i + 2 < index_count; i += 3)
+            {
+                u32 triangle[3];
+
+                for (u32 corner = 0; corner < 3; corner++)
+                {
+                    u32& index = remap[indices[i + corner]];
+
+                    if (index == std::numeric_limits<u32>::max())
+                    {
+                        const glm::vec3& pos = vertices[indices[i + corner]].pos;
+
+                        auto [it, inserted] = unique.emplace(pos, static_cast<u32>(result.positions.size()));
+
+                        if (inserted)
+                        {
+                            result.positions.push_back(pos);
+                        }
+
+                        index = it->second;
+                    }
+
+                    triangle[corner] = index;
+                }
+
+                //merged corners may collapse a triangle, it has no area to collide with
+                if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[2] == triangle[0])
+                {
+                    continue;
+                }
+
+                result.indices.insert(result.indices.end(), triangle, triangle + 3);
+            }
+
+            result.positions.shrink_to_fit();
+            result.indices.shrink_to_fit();
+
+            std::vector<Triangle> triangles;
+            triangles.reserve(result.indices.size() / 3);
+
+            for (u32 i = 0; i + 2 < result.indices.size(); i += 3)
+            {
+                triangles.emplace_back(result.positions[result.indices[i + 0]], result.positions[result.indices[i + 1]], result.positions[result.indices[i + 2]]);
+            }
+
+            result.bvh.build(triangles);
+
+            return result;
+        }
+    }
+
+    /**
+     * parse .obj file, the mesh is centered, welded into cache friendly indexed triangles and gets its lods, collision mesh and hull
+     */
+    MeshData MeshFile::loadObj(File& input_file)
+    {
+        MeshData result;
+
+        std::vector<Vertex> vertices = parseObj(input_file, result);
+
+        glm::vec3 center;
+        float     size_delta;
+        normalization(vertices, center, size_delta);
+
+        float furthest_vertex_value = 0.0f;
+
+        for (auto& vertex : vertices)
+        {
+            vertex.pos = (vertex.pos - center) * size_delta;
+            furthest_vertex_value = std::max(furthest_vertex_value, glm::dot(vertex.pos, vertex.pos));
+        }
+
+        result.furthest_vertex_value = std::sqrt(furthest_vertex_value);
+
+        // shared corners become one vertex
+        weldVertices(vertices, result.indices);
+
+        // reorder for the post transform cache, then lay the vertices out in the order they are fetched
+        std::vector<u32> reordered(result.indices);
+        MeshOptimizer::optimizeVertexCache(reordered, static_cast<u32>(vertices.size()));
+
+        float acmr_before = MeshOptimizer::acmr(result.indices, static_cast<u32>(vertices.size()));
+        float acmr_after  = MeshOptimizer::acmr(reordered,      static_cast<u32>(vertices.size()));
+
+        //the exporter's order is kept if it was already as good
+        if (acmr_after < acmr_before)
+        {
+            result.indices = std::move(reordered);
+        }
+
+        MeshOptimizer::optimizeVertexFetch(vertices, result.indices);
+
+        // every lod halves the triangles of the previous one, all of them index the same vertices
+        result.lods.push_back({ 0, static_cast<u32>(result.indices.size()), 0.0f });
+
+        std::vector<u32> previous = result.indices;
+
+        while (result.lods.size() < MaxLods)
+        {
+            u32 target = static_cast<u32>(previous.size() / 6 * 3);
+
+            if (target < MinLodTriangles * 3)
+            {
+                break;
+            }
+
+            float            error = 0.0f;
+            std::vector<u32> lod   = MeshOptimizer::simplify(vertices, previous, target, error);
+
+            //the rest of the collapses would turn triangles over
+            if (lod.size() * 4 > previous.size() * 3)
+            {
+                break;
+            }
+
+            MeshOptimizer::optimizeVertexCache(lod, static_cast<u32>(vertices.size()));
+
+            u32 offset = static_cast<u32>(result.indices.size() + result.lod_indices.size());
+            result.lods.push_back({ offset, static_cast<u32>(lod.size()), result.lods.back().error + error });
+            result.lod_indices.insert(result.lod_indices.end(), lod.begin(), lod.end());
+
+            previous = std::move(lod);
+        }
+
+        // collision mesh made by hand next to the file, otherwise the coarsest lod that keeps the shape
+        std::string collision_path = MeshFile::collisionPath(input_file.getPath());
+        File        collision_file(collision_path);
+
+        result.collision_from_file = collision_file.isFile();
+
+        if (result.collision_from_file)
+        {
+            MeshData            ignored;
+            std::vector<Vertex> collision_vertices = parseObj(collision_file, ignored);
+            collision_file.close();
+
+            //the proxy has to stay in the space of the render mesh
+            for (auto& vertex : collision_vertices)
+            {
+                vertex.pos = (vertex.pos - center) * size_delta;
+            }
+
+            std::vector<u32> soup(collision_vertices.size());
+            std::iota(soup.begin(), soup.end(), 0);
+
+            result.collision = buildCollisionMesh(collision_vertices, soup.data(), static_cast<u32>(soup.size()));
+
+            //bounding boxes have to hold the proxy too, it may stick out of the render mesh
+            for (const glm::vec3& pos : result.collision.positions)
+            {
+                result.furthest_vertex_value = std::max(result.furthest_vertex_value, glm::length(pos));
+            }
+        }
+        else
+        {
+            const MeshLod* proxy = &result.lods.front();
+
+            for (const MeshLod& lod : result.lods)
+            {
+                if (lod.error <= CollisionMaxError)
+                {
+                    proxy = &lod;
+                }
+            }
+
+            //lod offsets continue after the indices of the full mesh
+            const u32* proxy_indices = proxy->index_offset < result.indices.size() ? result.indices.data() + proxy->index_offset
+                                                                                   : result.lod_indices.data() + (proxy->index_offset - result.indices.size());
+
+            result.collision = buildCollisionMesh(vertices, proxy_indices, proxy->index_count);
+        }
+
+        // build the hull used by the convex collision tests
+        result.hull.build(result.collision.positions);
+
+        //one line per mesh, the loading workers share the output
+        std::printf("Mesh() log: loaded file: %s - %u vertices, acmr %.3f -> %.3f, %u lods, collision: %u triangles from %s, hull: %u vertices\n",
+                    input_file.getPath().c_str(), static_cast<u32>(vertices.size()), acmr_before, std::min(acmr_before, acmr_after),
+                    static_cast<u32>(result.lods.size()), static_cast<u32>(result.collision.indices.size() / 3),
+                    result.collision_from_file ? "file" : "lod", static_cast<u32>(result.hull.points().size()));
+
+        result.vertices = std::move(vertices);
+
+        return result;
+    }
+
+    namespace
+    {
+        u64 alignBlock(u64 offset)
+        {
+            return (offset + MeshFile::BlockAlignment - 1) / MeshFile::BlockAlignment * MeshFile::BlockAlignment;
+        }
+
+        /**
+         * split the names stored in a block, they are separated by new lines
+         */
+        std::vector<std::string> splitLines(const std::string& text)
+        {
+            std::vector<std::string> result;
+            u64                      start = 0;
+
+            while (start < text.size())
+            {
+                u64 end = std::min(text.find('\n', start), text.size());
+
+                result.push_back(text.substr(start, end - start));
+                start = end + 1;
+            }
+
+            return result;
+        }
+    }
+
+    /**
+     * map cooked mesh and copy the blocks out of it
+     */
+    MeshData MeshFile::loadCooked(const std::string& path)
+    {
+        MappedFile file(path);
+
+        if (file.opened() == false || file.size() < sizeof(Header))
+        {
+            throw std::runtime_error("MeshFile::loadCooked() error: file cannot be mapped: " + path);
+        }
+
+        Header header;
+        std::memcpy(&header, file.data(), sizeof(Header));
+
+        if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version)
+        {
+            throw std::runtime_error("MeshFile::loadCooked() error: not a cooked mesh of this version: " + path);
+        }
+
+        u64 offset = sizeof(Header);
+
+        //copy the next block out of the mapping
+        auto read_block = [&](auto& block, u32 count)
+        {
+            using Element = typename std::decay_t<decltype(block)>::value_type;
+            static_assert(std::is_trivially_copyable_v<Element>, "cooked blocks are copied as raw bytes");
+
+            offset = alignBlock(offset);
+
+            if (offset + static_cast<u64>(count) * sizeof(Element) > file.size())
+            {
+                throw std::runtime_error("MeshFile::loadCooked() error: truncated file: " + path);
+            }
+
+            block.resize(count);
+
+            if (count != 0)
+            {
+                std::memcpy(block.data(), file.data() + offset, count * sizeof(Element));
+            }
+
+            offset += static_cast<u64>(count) * sizeof(Element);
+        };
+
+        MeshData data;
+
+        std::vector<glm::vec3>                     collision_positions;
+        std::vector<u32>                           collision_indices;
+        std::vector<BoundingVolumeHierarchy::Node> bvh_nodes;
+        std::vector<u32>                           bvh_triangles;
+        std::vector<glm::vec3>                     hull_points;
+        std::vector<ConvexHull::Face>              hull_faces;
+        std::vector<glm::vec3>                     hull_normals;
+        std::vector<glm::vec3>                     hull_edges;
+        std::vector<u32>                           hull_adjacency_offsets;
+        std::vector<u32>                           hull_adjacency;
+        std::vector<char>                          diffuse_map;
+        std::vector<char>                          material_files;
+
+        read_block(data.vertices,          header.vertex_count);
+        read_block(data.indices,           header.index_count);
+        read_block(data.lod_indices,       header.lod_index_count);
+        read_block(data.lods,              header.lod_count);
+        read_block(collision_positions,    header.collision_position_count);
+        read_block(collision_indices,      header.collision_index_count);
+        read_block(bvh_nodes,              header.bvh_node_count);
+        read_block(bvh_triangles,          header.bvh_triangle_count);
+        read_block(hull_points,            header.hull_point_count);
+        read_block(hull_faces,             header.hull_face_count);
+        read_block(hull_normals,           header.hull_normal_count);
+        read_block(hull_edges,             header.hull_edge_count);
+        read_block(hull_adjacency_offsets, header.hull_point_count != 0 ? header.hull_point_count + 1 : 0);
+        read_block(hull_adjacency,         header.hull_adjacency_count);
+        read_block(diffuse_map,            header.diffuse_map_length);
+        read_block(material_files,         header.material_files_length);
+
+        data.collision.positions = std::move(collision_positions);
+        data.collision.indices   = std::move(collision_indices);
+        data.collision.bvh.assign(std::move(bvh_nodes), std::move(bvh_triangles), header.bvh_depth);
+        data.hull.assign(std::move(hull_points), std::move(hull_faces), std::move(hull_normals), std::move(hull_edges),
+                         std::move(hull_adjacency_offsets), std::move(hull_adjacency));
+
+        data.furthest_vertex_value = header.furthest_vertex_value;
+        data.has_material          = header.has_material != 0;
+        data.has_uv                = header.has_uv != 0;
+        data.collision_from_file   = header.collision_from_file != 0;
+        data.diffuse               = glm::vec3(header.diffuse[0],  header.diffuse[1],  header.diffuse[2]);
+        data.ambient               = glm::vec3(header.ambient[0],  header.ambient[1],  header.ambient[2]);
+        data.specular              = glm::vec3(header.specular[0], header.specular[1], header.specular[2]);
+        data.diffuse_map           = std::string(diffuse_map.begin(), diffuse_map.end());
+        data.material_files        = splitLines(std::string(material_files.begin(), material_files.end()));
+
+        std::printf("Mesh() log: %s - mapped cooked mesh\n", path.c_str());
+
+        return data;
+    }
+
+    /**
+     * write cooked mesh
+     */
+    void MeshFile::saveCooked(const MeshData& data, const std::string& path)
+    {
+        Header header;
+        std::memset(&header, 0, sizeof(Header));
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+
+        header.version               = Version;
+        header.vertex_count          = static_cast<u32>(data.vertices.size());
+        header.index_count           = static_cast<u32>(data.indices.size());
+        header.lod_index_count       = static_cast<u32>(data.lod_indices.size());
+        header.lod_count             = static_cast<u32>(data.lods.size());
+        header.collision_position_count = static_cast<u32>(data.collision.positions.size());
+        header.collision_index_count    = static_cast<u32>(data.collision.indices.size());
+        header.bvh_node_count        = static_cast<u32>(data.collision.bvh.nodes().size());
+        header.bvh_triangle_count    = static_cast<u32>(data.collision.bvh.triangles().size());
+        header.bvh_depth             = data.collision.bvh.depth();
+        header.hull_point_count      = static_cast<u32>(data.hull.points().size());
+        header.hull_face_count       = static_cast<u32>(data.hull.faces().size());
+        header.hull_normal_count     = static_cast<u32>(data.hull.normals().size());
+        header.hull_edge_count       = static_cast<u32>(data.hull.edges().size());
+        header.hull_adjacency_count  = static_cast<u32>(data.hull.adjacency().size());
+        header.furthest_vertex_value = data.furthest_vertex_value;
+        header.has_material          = data.has_material ? 1 : 0;
+        header.has_uv                = data.has_uv ? 1 : 0;
+        header.collision_from_file   = data.collision_from_file ? 1 : 0;
+        header.diffuse_map_length    = static_cast<u32>(data.diffuse_map.size());
+
+        std::string material_files;
+
+        for (auto& material_file : data.material_files)
+        {
+            material_files += (material_files.empty() ? "" : "\n") + material_file;
+        }
+
+        header.material_files_length = static_cast<u32>(material_files.size());
+
+        for (u32 i = 0; i < 3; i++)
+        {
+            header.diffuse[i]  = data.diffuse[i];
+            header.ambient[i]  = data.ambient[i];
+            header.specular[i] = data.specular[i];
+        }
+
+        std::vector<u8> buffer(sizeof(Header));
+        std::memcpy(buffer.data(), &header, sizeof(Header));
+
+        auto write_block = [&](const void* block, u64 size)
+        {
+            buffer.resize(alignBlock(buffer.size()), 0);
+            buffer.insert(buffer.end(), static_cast<const u8*>(block), static_cast<const u8*>(block) + size);
+        };
+
+        write_block(data.vertices.data(),             data.vertices.size()             * sizeof(Vertex));
+        write_block(data.indices.data(),              data.indices.size()              * sizeof(u32));
+        write_block(data.lod_indices.data(),          data.lod_indices.size()          * sizeof(u32));
+        write_block(data.lods.data(),                 data.lods.size()                 * sizeof(MeshLod));
+        write_block(data.collision.positions.data(),  data.collision.positions.size()  * sizeof(glm::vec3));
+        write_block(data.collision.indices.data(),    data.collision.indices.size()    * sizeof(u32));
+        write_block(data.collision.bvh.nodes().data(),     data.collision.bvh.nodes().size()     * sizeof(BoundingVolumeHierarchy::Node));
+        write_block(data.collision.bvh.triangles().data(), data.collision.bvh.triangles().size() * sizeof(u32));
+        write_block(data.hull.points().data(),        data.hull.points().size()        * sizeof(glm::vec3));
+        write_block(data.hull.faces().data(),         data.hull.faces().size()         * sizeof(ConvexHull::Face));
+        write_block(data.hull.normals().data(),       data.hull.normals().size()       * sizeof(glm::vec3));
+        write_block(data.hull.edges().data(),         data.hull.edges().size()         * sizeof(glm::vec3));
+        write_block(data.hull.adjacencyOffsets().data(), data.hull.adjacencyOffsets().size() * sizeof(u32));
+        write_block(data.hull.adjacency().data(),     data.hull.adjacency().size()     * sizeof(u32));
+        write_block(data.diffuse_map.data(),          data.diffuse_map.size());
+        write_block(material_files.data(),            material_files.size());
+
+        File output(path, File::OpenMode::Write);
+
+        if (output.isFile() == false || output.write(buffer) != buffer.size())
+        {
+            throw std::runtime_error("MeshFile::saveCooked() error: file cannot be written: " + path);
+        }
+    }
+
+    /**
+     * get path of the cooked mesh made from the source file
+     */
+    std::string MeshFile::cookedPath(const std::string& path)
+    {
+        return std::filesystem::path(path).replace_extension(Extension).string();
+    }
+
+    /**
+     * get path of the collision mesh made for the source file
+     */
+    std::string MeshFile::collisionPath(const std::string& path)
+    {
+        std::filesystem::path source(path);
+
+        return (source.parent_path() / (source.stem().string() + CollisionSuffix + source.extension().string())).string();
+    }
+
+    /**
+     * get files besides the source the mesh was made from
+     */
+    std::vector<std::string> MeshFile::dependencies(const std::string& path, const MeshData& data)
+    {
+        std::vector<std::string> result;
+
+        if (std::filesystem::path(path).extension() == Extension)
+        {
+            return result;
+        }
+
+        result.push_back(collisionPath(path));
+
+        //resolved like loadObj() opens them
+        std::string folder = std::filesystem::path(path).parent_path().string();
+
+        for (auto& material_file : data.material_files)
+        {
+            result.push_back(folder + "/" + material_file);
+        }
+
+        return result;
+    }
+
+    /**
+     * check if the cooked mesh of the source file exists and isn't older than the source, its collision mesh or its material files
+     */
+    bool MeshFile::cookedUpToDate(const std::string& path)
+    {
+        //packs hold only the cooked meshes made when they were built
+        if (Pack::contains(cookedPath(path)))
+        {
+            return true;
+        }
+
+        std::error_code source_error;
+        std::error_code collision_error;
+        std::error_code cooked_error;
+
+        auto source_time    = std::filesystem::last_write_time(path, source_error);
+        auto collision_time = std::filesystem::last_write_time(collisionPath(path), collision_error);
+        auto cooked_time    = std::filesystem::last_write_time(cookedPath(path), cooked_error);
+
+        if (source_error || cooked_error || cooked_time < source_time || (!collision_error && cooked_time < collision_time))
+        {
+            return false;
+        }
+
+        //the collision mesh is optional, the cooked mesh is stale only if it was made from one that was removed since
+        MappedFile cooked(cookedPath(path));
+        Header     header;
+
+        if (cooked.opened() == false || cooked.size() < sizeof(Header))
+        {
+            return false;
+        }
+
+        std::memcpy(&header, cooked.data(), sizeof(Header));
+
+        if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version || (header.collision_from_file != 0 && collision_error) ||
+            header.material_files_length > cooked.size() - sizeof(Header))
+        {
+            return false;
+        }
+
+        //the material files end the cooked mesh, only the ones that still exist are compared
+        std::string material_files(reinterpret_cast<const char*>(cooked.data()) + cooked.size() - header.material_files_length, header.material_files_length);
+        std::string folder = std::filesystem::path(path).parent_path().string();
+
+        for (auto& material_file : splitLines(material_files))
+        {
+            std::error_code material_error;
+            auto            material_time = std::filesystem::last_write_time(folder + "/" + material_file, material_error);
+
+            if (!material_error && cooked_time < material_time)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
\ No newline at end of file
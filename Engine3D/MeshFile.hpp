@@ -0,0 +1,145 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include "Types.hpp"
+#include "File.hpp"
+#include "Mesh.hpp"
+#include "BoundingVolumeHierarchy.hpp"
+#include "ConvexHull.hpp"
+
+namespace Engine3D
+{
+    /**
+     * mesh decoded on the cpu, holds everything the gpu upload and the collisions need
+     */
+    struct MeshData
+    {
+        std::vector<Vertex>     vertices;
+        std::vector<u32>        indices; //triangle list, three indices into vertices per triangle
+        std::vector<u32>        lod_indices; //triangle lists of the coarser lods, offsets continue after indices
+        std::vector<MeshLod>    lods;
+        CollisionMesh           collision;
+        ConvexHull              hull; //built over the collision positions
+        bool                    collision_from_file { false }; //the collision mesh was read from collisionPath()
+        float                   furthest_vertex_value { 0 };
+        bool                    has_uv { false };
+
+        bool                    has_material { false };
+        glm::vec3               diffuse      { 0 };
+        glm::vec3               ambient      { 0 };
+        glm::vec3               specular     { 0 };
+        std::string             diffuse_map;
+        std::vector<std::string> material_files; //names in the mtllib lines, the files are next to the source
+    };
+
+    /**
+     * loading of .obj files and of the cooked binary meshes made from them
+     */
+    namespace MeshFile
+    {
+        /**
+         * cooked mesh starts with the header, the blocks follow in this order,
+         * each one starts at a multiple of BlockAlignment
+         *
+         * vertices | indices | lod indices | lods | collision positions | collision indices | bvh nodes | bvh triangles |
+         * hull points | hull faces | hull normals | hull edges | hull adjacency offsets | hull adjacency | diffuse map path |
+         * material files
+         *
+         * the material files are the names separated by new lines, the block ends the file
+         */
+        struct Header
+        {
+            char  magic[4];
+            u32   version;
+            u32   vertex_count;
+            u32   index_count;
+            u32   lod_index_count;
+            u32   lod_count;
+            u32   collision_position_count;
+            u32   collision_index_count;
+            u32   bvh_node_count;
+            u32   bvh_triangle_count;
+            u32   bvh_depth;
+            u32   hull_point_count;
+            u32   hull_face_count;
+            u32   hull_normal_count;
+            u32   hull_edge_count;
+            u32   hull_adjacency_count;
+            float furthest_vertex_value;
+            u32   has_material;
+            u32   has_uv;
+            u32   collision_from_file;
+            float diffuse[3];
+            float ambient[3];
+            float specular[3];
+            u32   diffuse_map_length;
+            u32   material_files_length;
+        };
+
+        constexpr char        Magic[4]       = { 'E', '3', 'D', 'M' };
+        constexpr u32         Version         = 8;
+        constexpr u64         BlockAlignment  = 16;
+        constexpr const char* Extension       = ".e3dmesh";
+        constexpr const char* CollisionSuffix = "_col"; //rock_col.obj is the collision mesh of rock.obj
+
+        /**
+         * parse .obj file, the mesh is centered, welded into cache friendly indexed triangles and gets its lods, collision mesh and hull
+         *
+         * the collision mesh is read from the file next to the source named by collisionPath(), if there is none
+         * the coarsest lod close enough to the full mesh is used
+         */
+        MeshData loadObj(File& input_file);
+
+        /**
+         * map cooked mesh and copy the blocks out of it
+         */
+        MeshData loadCooked(const std::string& path);
+
+        /**
+         * write cooked mesh
+         */
+        void saveCooked(const MeshData& data, const std::string& path);
+
+        /**
+         * get path of the cooked mesh made from the source file
+         */
+        std::string cookedPath(const std::string& path);
+
+        /**
+         * get path of the collision mesh made for the source file
+         */
+        std::string collisionPath(const std::string& path);
+
+        /**
+         * get files besides the source the mesh was made from, the collision mesh and the material files,
+         * a change of any of them changes the mesh, none if the path is a cooked mesh
+         */
+        std::vector<std::string> dependencies(const std::string& path, const MeshData& data);
+
+        /**
+         * check if the cooked mesh of the source file exists, is of this version and isn't older than the source, its collision mesh
+         * or its material files, it is stale if it was made with a collision mesh that no longer exists
+         */
+        bool cookedUpToDate(const std::string& path);
+    };
+};
\ No newline at end of file
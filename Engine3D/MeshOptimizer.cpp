@@ -0,0 +1,638 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "MeshOptimizer.hpp"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+
+namespace Engine3D
+{
+    namespace
+    {
+        //lru cache simulated while scoring, a bit bigger than the hardware fifo
+        constexpr u32   ScoringCacheSize   = 32;
+        constexpr float CacheDecayPower    = 1.5f;
+        constexpr float LastTriangleScore  = 0.75f;
+        constexpr float ValenceBoostScale  = 2.0f;
+        constexpr float ValenceBoostPower  = 0.5f;
+
+        constexpr u32   NotInCache         = std::numeric_limits<u32>::max();
+        constexpr u32   NoTriangle         = std::numeric_limits<u32>::max();
+
+        //open borders are held in place by planes perpendicular to them, weighted up against the surface
+        constexpr double BorderWeight      = 10.0;
+        //collapses turning a triangle by more than about 75 degrees are rejected
+        constexpr float  MinNormalCosine   = 0.25f;
+
+        /**
+         * score of a vertex, high for vertices recently used and for vertices with few triangles left
+         */
+        float vertexScore(u32 cache_position, u32 remaining_triangles)
+        {
+            if (remaining_triangles == 0)
+            {
+                return -1.0f;
+            }
+
+            float score = 0.0f;
+
+            if (cache_position != NotInCache)
+            {
+                //the last triangle's vertices get a fixed score so the next triangle doesn't just reuse its edge
+                if (cache_position < 3)
+                {
+                    score = LastTriangleScore;
+                }
+                else
+                {
+                    float scale = 1.0f / (ScoringCacheSize - 3);
+                    score = std::pow(1.0f - (cache_position - 3) * scale, CacheDecayPower);
+                }
+            }
+
+            //vertices with few triangles left are finished first, they would be lonely misses later
+            return score + ValenceBoostScale * std::pow(static_cast<float>(remaining_triangles), -ValenceBoostPower);
+        }
+
+        /**
+         * sum of squared distances to weighted planes, kept as the upper triangle of the symmetric 4x4 matrix
+         */
+        struct Quadric
+        {
+            double a00 { 0 }, a01 { 0 }, a02 { 0 }, a03 { 0 };
+            double            a11 { 0 }, a12 { 0 }, a13 { 0 };
+            double                       a22 { 0 }, a23 { 0 };
+            double                                  a33 { 0 };
+            double weight { 0 };
+
+            /**
+             * add plane dot(normal, p) + offset = 0
+             */
+            void addPlane(const glm::vec3& normal, float offset, double plane_weight)
+            {
+                double x = normal.x, y = normal.y, z = normal.z, d = offset;
+
+                a00 += plane_weight * x * x; a01 += plane_weight * x * y; a02 += plane_weight * x * z; a03 += plane_weight * x * d;
+                a11 += plane_weight * y * y; a12 += plane_weight * y * z; a13 += plane_weight * y * d;
+                a22 += plane_weight * z * z; a23 += plane_weight * z * d;
+                a33 += plane_weight * d * d;
+
+                weight += plane_weight;
+            }
+
+            Quadric& operator+=(const Quadric& other)
+            {
+                a00 += other.a00; a01 += other.a01; a02 += other.a02; a03 += other.a03;
+                a11 += other.a11; a12 += other.a12; a13 += other.a13;
+                a22 += other.a22; a23 += other.a23;
+                a33 += other.a33;
+
+                weight += other.weight;
+
+                return *this;
+            }
+
+            /**
+             * weighted sum of squared distances of the point to the planes
+             */
+            double evaluate(const glm::vec3& point) const
+            {
+                double x = point.x, y = point.y, z = point.z;
+
+                return a00 * x * x + 2.0 * a01 * x * y + 2.0 * a02 * x * z + 2.0 * a03 * x
+                                   +       a11 * y * y + 2.0 * a12 * y * z + 2.0 * a13 * y
+                                                       +       a22 * z * z + 2.0 * a23 * z
+                                                                           +       a33;
+            }
+        };
+
+        /**
+         * candidate moving all vertices at one position onto another position
+         */
+        struct Collapse
+        {
+            float cost;
+            u32   from;
+            u32   to;
+            u32   from_version;
+            u32   to_version;
+
+            bool operator>(const Collapse& other) const { return cost > other.cost; }
+        };
+    }
+
+    /**
+     * reorder triangles so the shared vertices stay in the post transform cache
+     */
+    void MeshOptimizer::optimizeVertexCache(std::vector<u32>& indices, u32 vertex_count)
+    {
+        u32 triangle_count = static_cast<u32>(indices.size() / 3);
+
+        if (triangle_count == 0)
+        {
+            return;
+        }
+
+        //triangles of each vertex, the ones not emitted yet are kept at the front of each range
+        std::vector<u32> remaining(vertex_count, 0);
+        std::vector<u32> offsets(vertex_count + 1, 0);
+
+        for (u32 i = 0; i < triangle_count * 3; i++)
+        {
+            remaining[indices[i]]++;
+        }
+
+        for (u32 v = 0; v < vertex_count; v++)
+        {
+            offsets[v + 1] = offsets[v] + remaining[v];
+        }
+
+        std::vector<u32> vertex_triangles(offsets[vertex_count]);
+        std::vector<u32> fill(offsets.begin(), offsets.end() - 1);
+
+        for (u32 t = 0; t < triangle_count; t++)
+        {
+            for (u32 k = 0; k < 3; k++)
+            {
+                vertex_triangles[fill[indices[t * 3 + k]]++] = t;
+            }
+        }
+
+        std::vector<u32>   cache_positions(vertex_count, NotInCache);
+        std::vector<float> vertex_scores(vertex_count);
+
+        for (u32 v = 0; v < vertex_count; v++)
+        {
+            vertex_scores[v] = vertexScore(NotInCache, remaining[v]);
+        }
+
+        std::vector<float> triangle_scores(triangle_count);
+        std::vector<bool>  emitted(triangle_count, false);
+
+        u32 best_triangle = 0;
+
+        for (u32 t = 0; t < triangle_count; t++)
+        {
+            triangle_scores[t] = vertex_scores[indices[t * 3 + 0]] + vertex_scores[indices[t * 3 + 1]] + vertex_scores[indices[t * 3 + 2]];
+
+            if (triangle_scores[t] > triangle_scores[best_triangle])
+            {
+                best_triangle = t;
+            }
+        }
+
+        std::vector<u32> result;
+        result.reserve(triangle_count * 3);
+
+        std::vector<u32> cache;
+        std::vector<u32> new_cache;
+        cache.reserve(ScoringCacheSize + 3);
+        new_cache.reserve(ScoringCacheSize + 3);
+
+        u32 scan_cursor = 0;
+
+        for (u32 n = 0; n < triangle_count; n++)
+        {
+            //nothing left around the cache, continue with the first triangle not emitted yet
+            if (best_triangle == NoTriangle)
+            {
+                while (emitted[scan_cursor])
+                {
+                    scan_cursor++;
+                }
+
+                best_triangle = scan_cursor;
+            }
+
+            const u32* triangle = &indices[best_triangle * 3];
+
+            emitted[best_triangle] = true;
+            new_cache.assign(triangle, triangle + 3);
+
+            for (u32 k = 0; k < 3; k++)
+            {
+                u32 v = triangle[k];
+                result.push_back(v);
+
+                //move the triangle behind the ones left
+                u32* begin = &vertex_triangles[offsets[v]];
+                u32* last  = begin + remaining[v] - 1;
+
+                for (u32* it = begin; it <= last; it++)
+                {
+                    if (*it == best_triangle)
+                    {
+                        std::swap(*it, *last);
+                        break;
+                    }
+                }
+
+                remaining[v]--;
+            }
+
+            //the emitted vertices go to the front of the lru cache
+            for (u32 v : cache)
+            {
+                if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                {
+                    new_cache.push_back(v);
+                }
+            }
+
+            std::swap(cache, new_cache);
+
+            for (u32 i = 0; i < cache.size(); i++)
+            {
+                u32 v = cache[i];
+
+                cache_positions[v] = i < ScoringCacheSize ? i : NotInCache;
+                vertex_scores[v]   = vertexScore(cache_positions[v], remaining[v]);
+            }
+
+            //rescore the triangles around the cache and pick the best of them
+            best_triangle    = NoTriangle;
+            float best_score = -std::numeric_limits<float>::max();
+
+            for (u32 v : cache)
+            {
+                for (u32 i = offsets[v]; i < offsets[v] + remaining[v]; i++)
+                {
+                    u32 t = vertex_triangles[i];
+
+                    triangle_scores[t] = vertex_scores[indices[t * 3 + 0]] + vertex_scores[indices[t * 3 + 1]] + vertex_scores[indices[t * 3 + 2]];
+
+                    if (triangle_scores[t] > best_score)
+                    {
+                        best_score    = triangle_scores[t];
+                        best_triangle = t;
+                    }
+                }
+            }
+
+            if (cache.size() > ScoringCacheSize)
+            {
+                cache.resize(ScoringCacheSize);
+            }
+        }
+
+        indices = std::move(result);
+    }
+
+    /**
+     * reorder vertices into the order of their first use and remap the indices
+     */
+    void MeshOptimizer::optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<u32>& indices)
+    {
+        std::vector<u32> remap(vertices.size(), std::numeric_limits<u32>::max());
+
+        std::vector<Vertex> result;
+        result.reserve(vertices.size());
+
+        for (u32& index : indices)
+        {
+            if (remap[index] == std::numeric_limits<u32>::max())
+            {
+                remap[index] = static_cast<u32>(result.size());
+                result.push_back(vertices[index]);
+            }
+
+            index = remap[index];
+        }
+
+        vertices = std::move(result);
+    }
+
+    /**
+     * average cache miss ratio, transformed vertices per triangle with a fifo cache
+     */
+    float MeshOptimizer::acmr(const std::vector<u32>& indices, u32 vertex_count, u32 cache_size)
+    {
+        if (indices.size() < 3)
+        {
+            return 0.0f;
+        }
+
+        //a vertex is in the fifo if fewer than cache_size misses happened since it was loaded
+        std::vector<u32> loaded_at(vertex_count, 0);
+        u32              misses = 0;
+
+        for (u32 index : indices)
+        {
+            if (loaded_at[index] == 0 || misses - loaded_at[index] >= cache_size)
+            {
+                misses++;
+                loaded_at[index] = misses;
+            }
+        }
+
+        return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    }
+
+    /**
+     * collapse edges in the order of their quadric error until at most target_index_count indices are left
+     */
+    std::vector<u32> MeshOptimizer::simplify(const std::vector<Vertex>& vertices, const std::vector<u32>& indices, u32 target_index_count, float& error)
+    {
+        error = 0.0f;
+
+        u32 vertex_count   = static_cast<u32>(vertices.size());
+        u32 triangle_count = static_cast<u32>(indices.size() / 3);
+
+        //vertices at one position differ only in normal or uv, they are collapsed together
+        std::vector<u32> order(vertex_count);
+        std::vector<u32> position_of(vertex_count);
+
+        for (u32 i = 0; i < vertex_count; i++)
+        {
+            order[i] = i;
+        }
+
+        auto position_less = [&](u32 a, u32 b)
+        {
+            const glm::vec3& pa = vertices[a].pos;
+            const glm::vec3& pb = vertices[b].pos;
+
+            if (pa.x != pb.x) { return pa.x < pb.x; }
+            if (pa.y != pb.y) { return pa.y < pb.y; }
+            return pa.z < pb.z;
+        };
+
+        std::sort(order.begin(), order.end(), position_less);
+
+        std::vector<std::vector<u32>> wedges(vertex_count);
+
+        for (u32 i = 0; i < vertex_count; i++)
+        {
+            u32 vertex = order[i];
+            u32 first  = (i > 0 && !position_less(order[i - 1], vertex)) ? position_of[order[i - 1]] : vertex;
+
+            position_of[vertex] = first;
+            wedges[first].push_back(vertex);
+        }
+
+        std::vector<u32>              triangles(indices.begin(), indices.begin() + triangle_count * 3);
+        std::vector<bool>             triangle_removed(triangle_count, false);
+        std::vector<std::vector<u32>> position_triangles(vertex_count);
+        std::vector<Quadric>          quadrics(vertex_count);
+
+        auto position = [&](u32 triangle, u32 corner) { return position_of[triangles[triangle * 3 + corner]]; };
+
+        //every triangle adds its plane weighted by its area
+        std::unordered_map<u64, u32> edge_uses;
+
+        for (u32 t = 0; t < triangle_count; t++)
+        {
+            const glm::vec3& p0 = vertices[position(t, 0)].pos;
+            const glm::vec3& p1 = vertices[position(t, 1)].pos;
+            const glm::vec3& p2 = vertices[position(t, 2)].pos;
+
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            float     length = glm::length(normal);
+
+            for (u32 k = 0; k < 3; k++)
+            {
+                position_triangles[position(t, k)].push_back(t);
+
+                u32 a = position(t, k);
+                u32 b = position(t, (k + 1) % 3);
+                edge_uses[(static_cast<u64>(std::min(a, b)) << 32) | std::max(a, b)]++;
+            }
+
+            if (length > 0.0f)
+            {
+                normal /= length;
+
+                for (u32 k = 0; k < 3; k++)
+                {
+                    quadrics[position(t, k)].addPlane(normal, -glm::dot(normal, p0), length * 0.5f);
+                }
+            }
+        }
+
+        //edges of one triangle only are on an open border
+        for (u32 t = 0; t < triangle_count; t++)
+        {
+            const glm::vec3& p0 = vertices[position(t, 0)].pos;
+            glm::vec3 normal = glm::cross(vertices[position(t, 1)].pos - p0, vertices[position(t, 2)].pos - p0);
+
+            for (u32 k = 0; k < 3; k++)
+            {
+                u32 a = position(t, k);
+                u32 b = position(t, (k + 1) % 3);
+
+                if (edge_uses[(static_cast<u64>(std::min(a, b)) << 32) | std::max(a, b)] != 1)
+                {
+                    continue;
+                }
+
+                glm::vec3 edge         = vertices[b].pos - vertices[a].pos;
+                glm::vec3 border_plane = glm::cross(edge, normal);
+                float     length       = glm::length(border_plane);
+
+                if (length > 0.0f)
+                {
+                    border_plane /= length;
+
+                    double plane_weight = BorderWeight * glm::dot(edge, edge);
+
+                    quadrics[a].addPlane(border_plane, -glm::dot(border_plane, vertices[a].pos), plane_weight);
+                    quadrics[b].addPlane(border_plane, -glm::dot(border_plane, vertices[a].pos), plane_weight);
+                }
+            }
+        }
+
+        std::vector<u32>  versions(vertex_count, 0);
+        std::vector<bool> collapsed(vertex_count, false);
+
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> candidates;
+
+        auto push_candidate = [&](u32 from, u32 to)
+        {
+            Quadric quadric = quadrics[from];
+            quadric += quadrics[to];
+
+            double cost = quadric.weight > 0.0 ? std::max(quadric.evaluate(vertices[to].pos) / quadric.weight, 0.0) : 0.0;
+
+            candidates.push({ static_cast<float>(cost), from, to, versions[from], versions[to] });
+        };
+
+        //both directions of every edge around the position
+        auto push_edges = [&](u32 center)
+        {
+            for (u32 t : position_triangles[center])
+            {
+                for (u32 k = 0; k < 3; k++)
+                {
+                    u32 other = position(t, k);
+
+                    if (other != center)
+                    {
+                        push_candidate(center, other);
+                        push_candidate(other, center);
+                    }
+                }
+            }
+        };
+
+        for (u32 v = 0; v < vertex_count; v++)
+        {
+            if (position_of[v] == v)
+            {
+                push_edges(v);
+            }
+        }
+
+        u32   triangles_left   = triangle_count;
+        u32   target_triangles = target_index_count / 3;
+        float max_cost         = 0.0f;
+
+        while (triangles_left > target_triangles && candidates.empty() == false)
+        {
+            Collapse collapse = candidates.top();
+            candidates.pop();
+
+            if (collapsed[collapse.from] || collapsed[collapse.to] ||
+                versions[collapse.from] != collapse.from_version || versions[collapse.to] != collapse.to_version)
+            {
+                continue;
+            }
+
+            const glm::vec3& to_pos = vertices[collapse.to].pos;
+
+            //the positions have to share a triangle and no other triangle may turn over
+            bool adjacent = false;
+            bool valid    = true;
+
+            for (u32 t : position_triangles[collapse.from])
+            {
+                if (triangle_removed[t])
+                {
+                    continue;
+                }
+
+                glm::vec3 before[3];
+                glm::vec3 after[3];
+                bool      shared = false;
+
+                for (u32 k = 0; k < 3; k++)
+                {
+                    u32 p = position(t, k);
+
+                    shared   |= p == collapse.to;
+                    before[k] = vertices[p].pos;
+                    after[k]  = p == collapse.from ? to_pos : before[k];
+                }
+
+                if (shared)
+                {
+                    adjacent = true;
+                    continue;
+                }
+
+                glm::vec3 normal_before = glm::cross(before[1] - before[0], before[2] - before[0]);
+                glm::vec3 normal_after  = glm::cross(after[1]  - after[0],  after[2]  - after[0]);
+
+                if (glm::dot(normal_before, normal_after) <= MinNormalCosine * glm::length(normal_before) * glm::length(normal_after))
+                {
+                    valid = false;
+                    break;
+                }
+            }
+
+            if (adjacent == false || valid == false)
+            {
+                continue;
+            }
+
+            max_cost = std::max(max_cost, collapse.cost);
+
+            collapsed[collapse.from] = true;
+            quadrics[collapse.to]   += quadrics[collapse.from];
+            versions[collapse.to]++;
+
+            std::vector<u32>& to_triangles = position_triangles[collapse.to];
+
+            for (u32 t : position_triangles[collapse.from])
+            {
+                if (triangle_removed[t])
+                {
+                    continue;
+                }
+
+                if (position(t, 0) == collapse.to || position(t, 1) == collapse.to || position(t, 2) == collapse.to)
+                {
+                    triangle_removed[t] = true;
+                    triangles_left--;
+                    continue;
+                }
+
+                //each corner takes the vertex at the new position whose normal fits it best
+                for (u32 k = 0; k < 3; k++)
+                {
+                    u32& corner = triangles[t * 3 + k];
+
+                    if (position_of[corner] != collapse.from)
+                    {
+                        continue;
+                    }
+
+                    u32   best       = wedges[collapse.to][0];
+                    float best_match = -std::numeric_limits<float>::max();
+
+                    for (u32 wedge : wedges[collapse.to])
+                    {
+                        float match = glm::dot(vertices[wedge].nor, vertices[corner].nor);
+
+                        if (match > best_match)
+                        {
+                            best_match = match;
+                            best       = wedge;
+                        }
+                    }
+
+                    corner = best;
+                }
+
+                to_triangles.push_back(t);
+            }
+
+            position_triangles[collapse.from].clear();
+
+            to_triangles.erase(std::remove_if(to_triangles.begin(), to_triangles.end(), [&](u32 t) { return triangle_removed[t]; }), to_triangles.end());
+
+            push_edges(collapse.to);
+        }
+
+        std::vector<u32> result;
+        result.reserve(triangles_left * 3);
+
+        for (u32 t = 0; t < triangle_count; t++)
+        {
+            if (triangle_removed[t] == false)
+            {
+                result.insert(result.end(), &triangles[t * 3], &triangles[t * 3] + 3);
+            }
+        }
+
+        error = std::sqrt(max_cost);
+
+        return result;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,62 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <vector>
+
+#include "Types.hpp"
+#include "Mesh.hpp"
+
+namespace Engine3D
+{
+    /**
+     * reordering of indexed triangle lists for the gpu vertex caches
+     */
+    namespace MeshOptimizer
+    {
+        /**
+         * size of the fifo post transform cache used for the statistics
+         */
+        constexpr u32 StatisticsCacheSize = 16;
+
+        /**
+         * reorder triangles so the shared vertices stay in the post transform cache,
+         * uses the Forsyth scoring over a simulated lru cache
+         */
+        void optimizeVertexCache(std::vector<u32>& indices, u32 vertex_count);
+
+        /**
+         * reorder vertices into the order of their first use and remap the indices,
+         * vertices which aren't referenced are dropped
+         */
+        void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<u32>& indices);
+
+        /**
+         * average cache miss ratio, transformed vertices per triangle with a fifo cache,
+         * 0.5 is the best reachable on big regular meshes and 3 the worst
+         */
+        float acmr(const std::vector<u32>& indices, u32 vertex_count, u32 cache_size = StatisticsCacheSize);
+
+        /**
+         * collapse edges in the order of their quadric error until at most target_index_count indices are left,
+         * vertices are only moved onto other vertices so the result indexes the same vertex buffer
+         *
+         * \arg error - set to the rms distance of the simplified surface from the source in mesh space
+         */
+        std::vector<u32> simplify(const std::vector<Vertex>& vertices, const std::vector<u32>& indices, u32 target_index_count, float& error);
+    };
+};
\ No newline at end of file
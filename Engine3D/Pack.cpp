@@ -0,0 +1,335 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "Pack.hpp"
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <cstring>
+#include <stdexcept>
+
+#include "File.hpp"
+#include "LZ4.hpp"
+#include "System.hpp"
+
+namespace Engine3D
+{
+    namespace
+    {
+        /**
+         * mapped pack
+         */
+        struct Mounted
+        {
+            std::string path;
+            MappedFile  file;
+        };
+
+        /**
+         * file of a mounted pack
+         */
+        struct Location
+        {
+            const Mounted* pack;
+            Pack::Entry    entry;
+        };
+
+        std::vector<std::unique_ptr<Mounted>> g_packs;
+        std::map<std::string, Location>       g_files; //by name, sorted so the files of a directory are next to each other
+
+        u64 alignBlock(u64 offset)
+        {
+            return (offset + Pack::BlockAlignment - 1) / Pack::BlockAlignment * Pack::BlockAlignment;
+        }
+
+        /**
+         * get name of the file in the packs, full paths lose the executable folder
+         */
+        std::string packName(const std::string& path)
+        {
+            std::string root = System::getFullPath("");
+
+            return path.compare(0, root.size(), root) == 0 ? path.substr(root.size()) : path;
+        }
+
+        /**
+         * get name of the directory with the separator, names of the files in it start with it
+         */
+        std::string directoryPrefix(const std::string& path)
+        {
+            std::string name = packName(path);
+
+            return name.empty() || name.back() == '/' || name.back() == '\\' ? name : name + "/";
+        }
+    }
+
+    /**
+     * map the pack
+     */
+    bool Pack::mount(const std::string& path)
+    {
+        auto pack  = std::make_unique<Mounted>();
+        pack->path = path;
+        pack->file.open(path);
+
+        if (pack->file.opened() == false)
+        {
+            return false;
+        }
+
+        const u8* data = pack->file.data();
+        u64       size = pack->file.size();
+
+        Header header;
+
+        if (size < sizeof(Header))
+        {
+            throw std::runtime_error("Pack::mount() error: not a pack: " + path);
+        }
+
+        std::memcpy(&header, data, sizeof(Header));
+
+        if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version)
+        {
+            throw std::runtime_error("Pack::mount() error: not a pack of this version: " + path);
+        }
+
+        if (header.entries_offset > size || header.entry_count > (size - header.entries_offset) / sizeof(Entry))
+        {
+            throw std::runtime_error("Pack::mount() error: entries out of the file: " + path);
+        }
+
+        u64 names_offset = header.entries_offset + static_cast<u64>(header.entry_count) * sizeof(Entry);
+
+        if (header.names_size > size - names_offset)
+        {
+            throw std::runtime_error("Pack::mount() error: names out of the file: " + path);
+        }
+
+        const char* names = reinterpret_cast<const char*>(data + names_offset);
+
+        //the files are added once every entry checks out, a corrupted pack leaves nothing behind
+        std::vector<std::pair<std::string, Entry>> files;
+        files.reserve(header.entry_count);
+
+        for (u32 i = 0; i < header.entry_count; i++)
+        {
+            Entry entry;
+            std::memcpy(&entry, data + header.entries_offset + i * sizeof(Entry), sizeof(Entry));
+
+            if (entry.offset > size || entry.size > size - entry.offset ||
+                static_cast<u64>(entry.name_offset) + entry.name_length > header.names_size ||
+                (entry.compression == static_cast<u32>(Compression::None) && entry.size != entry.original_size) ||
+                entry.compression > static_cast<u32>(Compression::LZ4))
+            {
+                throw std::runtime_error("Pack::mount() error: corrupted entry: " + path);
+            }
+
+            files.emplace_back(std::string(names + entry.name_offset, entry.name_length), entry);
+        }
+
+        //packs mounted earlier keep their files
+        for (auto& [name, entry] : files)
+        {
+            g_files.emplace(std::move(name), Location { pack.get(), entry });
+        }
+
+        g_packs.push_back(std::move(pack));
+
+        return true;
+    }
+
+    /**
+     * unmap the pack
+     */
+    void Pack::unmount(const std::string& path)
+    {
+        for (u64 i = 0; i < g_packs.size(); i++)
+        {
+            if (g_packs[i]->path != path)
+            {
+                continue;
+            }
+
+            for (auto it = g_files.begin(); it != g_files.end(); )
+            {
+                it = it->second.pack == g_packs[i].get() ? g_files.erase(it) : std::next(it);
+            }
+
+            g_packs.erase(g_packs.begin() + i);
+            return;
+        }
+    }
+
+    /**
+     * find the file in the mounted packs
+     */
+    bool Pack::open(const std::string& path, View& view)
+    {
+        auto it = g_files.find(packName(path));
+
+        if (it == g_files.end())
+        {
+            return false;
+        }
+
+        const Entry& entry = it->second.entry;
+        const u8*    data  = it->second.pack->file.data() + entry.offset;
+
+        if (entry.compression == static_cast<u32>(Compression::None))
+        {
+            view.data = data;
+            view.size = entry.size;
+            return true;
+        }
+
+        view.buffer.resize(entry.original_size);
+
+        if (LZ4::decompress(data, entry.size, view.buffer.data(), view.buffer.size()) == false)
+        {
+            throw std::runtime_error("Pack::open() error: corrupted file: " + path);
+        }
+
+        view.data = view.buffer.data();
+        view.size = view.buffer.size();
+
+        return true;
+    }
+
+    /**
+     * check if the file is in the mounted packs
+     */
+    bool Pack::contains(const std::string& path)
+    {
+        return g_files.find(packName(path)) != g_files.end();
+    }
+
+    /**
+     * check if files of the mounted packs are in the directory
+     */
+    bool Pack::isDirectory(const std::string& path)
+    {
+        std::string prefix = directoryPrefix(path);
+        auto        it     = g_files.lower_bound(prefix);
+
+        return it != g_files.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+    }
+
+    /**
+     * get names of the files and directories in the directory
+     */
+    std::vector<std::string> Pack::list(const std::string& path)
+    {
+        std::vector<std::string> result;
+        std::string              prefix = directoryPrefix(path);
+
+        for (auto it = g_files.lower_bound(prefix); it != g_files.end() && it->first.compare(0, prefix.size(), prefix) == 0; it++)
+        {
+            //files in subdirectories are listed as their directory
+            std::string name = it->first.substr(prefix.size(), it->first.find('/', prefix.size()) - prefix.size());
+
+            if (result.empty() || result.back() != name)
+            {
+                result.push_back(std::move(name));
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * add file
+     */
+    void Pack::Writer::add(const std::string& name, const std::vector<u8>& data, bool compress)
+    {
+        Entry entry;
+        std::memset(&entry, 0, sizeof(Entry));
+
+        entry.size          = data.size();
+        entry.original_size = data.size();
+        entry.name_offset   = static_cast<u32>(m_names.size());
+        entry.name_length   = static_cast<u32>(name.size());
+        entry.compression   = static_cast<u32>(Compression::None);
+
+        //offsets are relative to the end of the header until the pack is saved
+        m_files.resize(alignBlock(m_files.size()), 0);
+        entry.offset = m_files.size();
+
+        std::vector<u8> compressed;
+
+        if (compress && data.empty() == false)
+        {
+            compressed = LZ4::compress(data.data(), data.size());
+        }
+
+        if (compressed.empty() == false && compressed.size() < data.size() * CompressionThreshold)
+        {
+            entry.size        = compressed.size();
+            entry.compression = static_cast<u32>(Compression::LZ4);
+            m_files.insert(m_files.end(), compressed.begin(), compressed.end());
+        }
+        else
+        {
+            m_files.insert(m_files.end(), data.begin(), data.end());
+        }
+
+        m_names += name;
+        m_entries.push_back(entry);
+    }
+
+    /**
+     * write the pack
+     */
+    void Pack::Writer::save(const std::string& path)
+    {
+        u64 files_offset = alignBlock(sizeof(Header));
+
+        Header header;
+        std::memset(&header, 0, sizeof(Header));
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+
+        header.version        = Version;
+        header.entry_count    = static_cast<u32>(m_entries.size());
+        header.names_size     = static_cast<u32>(m_names.size());
+        header.entries_offset = alignBlock(files_offset + m_files.size());
+
+        std::vector<u8> buffer(files_offset, 0);
+        std::memcpy(buffer.data(), &header, sizeof(Header));
+
+        buffer.insert(buffer.end(), m_files.begin(), m_files.end());
+        buffer.resize(header.entries_offset, 0);
+
+        for (Entry entry : m_entries)
+        {
+            entry.offset += files_offset;
+
+            const u8* bytes = reinterpret_cast<const u8*>(&entry);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(Entry));
+        }
+
+        buffer.insert(buffer.end(), m_names.begin(), m_names.end());
+
+        File output(path, File::OpenMode::Write);
+
+        if (output.isFile() == false || output.write(buffer) != buffer.size())
+        {
+            throw std::runtime_error("Pack::Writer::save() error: cannot write file: " + path);
+        }
+
+        output.close();
+    }
+};
\ No newline at end of file
@@ -0,0 +1,148 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include "Types.hpp"
+
+namespace Engine3D
+{
+    /**
+     * archive holding many files in one, the mounted packs are mapped into memory and File and MappedFile
+     * read the files found in them instead of the files on the disk
+     *
+     * the packs are mounted before the loading starts and stay mounted while files read from them are open,
+     * the lookups can run on any thread
+     */
+    namespace Pack
+    {
+        /**
+         * compression of one file in the pack
+         */
+        enum class Compression : u32
+        {
+            None,
+            LZ4
+        };
+
+        /**
+         * pack starts with the header, the files follow it, each one starts at a multiple of BlockAlignment,
+         * the entries and their names are at the end
+         *
+         * header | files | entries | names
+         */
+        struct Header
+        {
+            char  magic[4];
+            u32   version;
+            u32   entry_count;
+            u32   names_size;
+            u64   entries_offset;
+        };
+
+        struct Entry
+        {
+            u64   offset;
+            u64   size;          //bytes stored in the pack
+            u64   original_size; //bytes after decompression
+            u32   name_offset;   //into the names
+            u32   name_length;
+            u32   compression;
+            u32   reserved;
+        };
+
+        constexpr char        Magic[4]       = { 'E', '3', 'D', 'P' };
+        constexpr u32         Version        = 1;
+        constexpr u64         BlockAlignment = 16;
+        constexpr const char* Extension      = ".e3dpack";
+        constexpr const char* DefaultPath    = "data.e3dpack"; //mounted by the game if it exists
+
+        /**
+         * compressed file is stored only if it is smaller than this fraction of the original
+         */
+        constexpr float CompressionThreshold = 0.875f;
+
+        /**
+         * file read from a pack, points into the mapping or into the buffer if the file is compressed
+         */
+        struct View
+        {
+            const u8*       data { nullptr };
+            u64             size { 0 };
+            std::vector<u8> buffer;
+        };
+
+        /**
+         * map the pack, return false if it doesn't exist
+         *
+         * names of its files are relative to the executable folder, they are found by the same relative paths
+         * and by the full paths made by System::getFullPath(), the file of the pack mounted first is used
+         */
+        bool mount(const std::string& path);
+
+        /**
+         * unmap the pack
+         */
+        void unmount(const std::string& path);
+
+        /**
+         * find the file in the mounted packs, return false if it isn't in any
+         */
+        bool open(const std::string& path, View& view);
+
+        /**
+         * check if the file is in the mounted packs
+         */
+        bool contains(const std::string& path);
+
+        /**
+         * check if files of the mounted packs are in the directory
+         */
+        bool isDirectory(const std::string& path);
+
+        /**
+         * get names of the files and directories of the mounted packs in the directory
+         */
+        std::vector<std::string> list(const std::string& path);
+
+        /**
+         * builds a pack in memory and writes it
+         */
+        class Writer
+        {
+        public:
+
+            /**
+             * add file, it is compressed if that makes it smaller than CompressionThreshold of its size
+             */
+            void add(const std::string& name, const std::vector<u8>& data, bool compress = true);
+
+            /**
+             * write the pack
+             */
+            void save(const std::string& path);
+
+        private:
+
+            std::vector<u8>    m_files;
+            std::vector<Entry> m_entries;
+            std::string        m_names;
+        };
+    };
+};
\ No newline at end of file
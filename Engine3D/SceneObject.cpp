@@ -16,6 +16,9 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 */
 #include "SceneObject.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
 
 #include <GL/glew.h>
 #include <SDL2/SDL_ttf.h>
@@ -27,9 +30,10 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 
 namespace Engine3D
 {
-    void SceneObject::draw()
+    void SceneObject::draw(Camera& cam, float lod_scale)
     {
-        if(m_mesh.empty())
+        //meshes still loading aren't drawn
+        if(m_mesh.empty() || m_mesh.ready() == false)
         {
             return;
         }
@@ -40,24 +44,160 @@ namespace Engine3D
         glMultMatrixf(glm::value_ptr(m_rot));
         glScalef(m_scale.x, m_scale.y, m_scale.z);
         
-        m_mesh.draw();
+        m_mesh.draw(screenSize(cam, lod_scale));
 
         glPopMatrix();
     }
 
-    Triangle SceneObject::constructTriangle(u32 vert_index_start)
+    /**
+     * get size of the bounding box on screen in pixels
+     */
+    float SceneObject::screenSize(Camera& cam, float lod_scale)
     {
-        Triangle raw_triangle = m_mesh.constructTriangle(vert_index_start);
+        //the origin of the object in view space, the camera looks down -z
+        float distance = -(cam.getViewMatrix() * glm::vec4(m_pos, 1.0f)).z;
 
-        raw_triangle.p1 = glm::vec3(m_rot * glm::vec4(raw_triangle.p1, 1.0f));
-        raw_triangle.p2 = glm::vec3(m_rot * glm::vec4(raw_triangle.p2, 1.0f));
-        raw_triangle.p3 = glm::vec3(m_rot * glm::vec4(raw_triangle.p3, 1.0f));
+        if (lod_scale <= 0.0f || distance <= 0.0f)
+        {
+            return std::numeric_limits<float>::max();
+        }
 
-        raw_triangle.p1 = m_pos + raw_triangle.p1 * m_scale;
-        raw_triangle.p2 = m_pos + raw_triangle.p2 * m_scale;
-        raw_triangle.p3 = m_pos + raw_triangle.p3 * m_scale;
-        
-        return raw_triangle;
+        glm::vec3 dims = boundingBox().dims;
+        float     size = std::max(dims.x, std::max(dims.y, dims.z));
+
+        return size * lod_scale / distance;
+    }
+
+    /**
+     * recalculate the transform after pos(), rot() or scale() changed
+     */
+    void SceneObject::updateTransform() const
+    {
+        m_cached_pos   = m_pos;
+        m_cached_rot   = m_rot;
+        m_cached_scale = m_scale;
+
+        m_transform.rotation     = glm::mat3(m_rot);
+        m_transform.inv_rotation = glm::transpose(m_transform.rotation);
+        m_transform.abs_rotation = glm::mat3(glm::abs(m_transform.rotation[0]),
+                                             glm::abs(m_transform.rotation[1]),
+                                             glm::abs(m_transform.rotation[2]));
+        m_transform.inv_scale    = 1.0f / m_scale;
+
+        //stamps would alias after the wrap around
+        if (++m_transform.version == 0)
+        {
+            std::fill(m_world_triangle_stamps.begin(), m_world_triangle_stamps.end(), 0);
+            m_transform.version = 1;
+        }
+    }
+
+    /**
+     * get triangle in world space from the cache, transform it if it is stale
+     */
+    const Triangle& SceneObject::worldTriangle(u32 triangle, const CollisionMesh& collision)
+    {
+        const Transform&              t         = transform();
+        const std::vector<u32>&       indices   = collision.indices;
+        const std::vector<glm::vec3>& positions = collision.positions;
+
+        //mesh changed or was reloaded, a reload may keep the triangle count
+        if (m_world_triangles.size() != indices.size() / 3 || m_world_triangles_mesh_version != m_mesh.version())
+        {
+            m_world_triangles.assign(indices.size() / 3, Triangle());
+            m_world_triangle_stamps.assign(indices.size() / 3, 0);
+            m_world_triangles_mesh_version = m_mesh.version();
+        }
+
+        Triangle& world_triangle = m_world_triangles[triangle];
+
+        if (m_world_triangle_stamps[triangle] != t.version)
+        {
+            world_triangle.p1 = m_pos + (t.rotation * positions[indices[triangle * 3 + 0]]) * m_scale;
+            world_triangle.p2 = m_pos + (t.rotation * positions[indices[triangle * 3 + 1]]) * m_scale;
+            world_triangle.p3 = m_pos + (t.rotation * positions[indices[triangle * 3 + 2]]) * m_scale;
+
+            m_world_triangle_stamps[triangle] = t.version;
+        }
+
+        return world_triangle;
+    }
+
+    /**
+     * get all triangles of the collision mesh in world space
+     */
+    const std::vector<Triangle>& SceneObject::triangles()
+    {
+        const CollisionMesh& collision = collisionMesh();
+
+        for (u32 i = 0; i < collision.indices.size() / 3; i++)
+        {
+            worldTriangle(i, collision);
+        }
+
+        return m_world_triangles;
+    }
+
+    /**
+     * extract triangle from the collision mesh in world space, the start is a position in its indices
+     */
+    Triangle SceneObject::constructTriangle(u32 index_start)
+    {
+        const CollisionMesh& collision = collisionMesh();
+
+        if (index_start + 2 >= collision.indices.size())
+        {
+            throw std::runtime_error("SceneObject::constructTriangle() error: not enought vertices");
+        }
+
+        //triangles starting in the middle of a face aren't cached
+        if (index_start % 3 != 0)
+        {
+            return { localToWorld(collision.positions[collision.indices[index_start + 0]]),
+                     localToWorld(collision.positions[collision.indices[index_start + 1]]),
+                     localToWorld(collision.positions[collision.indices[index_start + 2]]) };
+        }
+
+        return worldTriangle(index_start / 3, collision);
+    }
+
+    /**
+     * get the point of the mesh furthest in the direction
+     */
+    glm::vec3 SceneObject::support(const glm::vec3& dir)
+    {
+        const Transform& t = transform();
+
+        //world = pos + (rotation * local) * scale, so the direction is mapped by the transposed linear part
+        glm::vec3 local_dir = t.inv_rotation * (dir * m_scale);
+
+        const ConvexHull& hull = this->hull();
+
+        //consecutive queries come from one test and go in similar directions
+        if (hull.empty() == false)
+        {
+            m_support_vertex = hull.support(local_dir, m_support_vertex);
+            return localToWorld(hull.points()[m_support_vertex]);
+        }
+
+        //flat meshes have no hull, all positions of the collision mesh are searched
+        const std::vector<glm::vec3>& positions = collisionMesh().positions;
+
+        u32   best_index = 0;
+        float best_value = -std::numeric_limits<float>::max();
+
+        for (u32 i = 0; i < positions.size(); i++)
+        {
+            float value = glm::dot(positions[i], local_dir);
+
+            if (value > best_value)
+            {
+                best_value = value;
+                best_index = i;
+            }
+        }
+
+        return positions.empty() ? m_pos : localToWorld(positions[best_index]);
     }
 
     /**
@@ -72,10 +212,8 @@ namespace Engine3D
 
         Vertex v = (*vertices())[i];
 
-        v.pos = glm::vec3(m_rot * glm::vec4(v.pos, 1.0f));
-        v.nor = glm::vec3(m_rot * glm::vec4(v.nor, 1.0f));
-
-        v.pos = m_pos + v.pos * m_scale;
+        v.pos = localToWorld(v.pos);
+        v.nor = transform().rotation * v.nor;
 
         return v;
     }
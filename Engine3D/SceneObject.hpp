@@ -22,8 +22,11 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 #include <glm/gtx/quaternion.hpp>
 
 #include "Mesh.hpp"
+#include "Camera.hpp"
 #include "Texture.hpp"
 #include "Shapes.hpp"
+#include "BoundingVolumeHierarchy.hpp"
+#include "ConvexHull.hpp"
 
 namespace Engine3D
 {
@@ -52,8 +55,8 @@ namespace Engine3D
          * explicit initializers
          */
         void init(glm::vec3 pos) { m_pos = pos; }
-        void init(glm::vec3 pos, const char* mesh_id) { m_pos = pos; m_mesh.init(mesh_id); }
-        void init(glm::vec3 pos, const std::string& mesh_id) { m_pos = pos; m_mesh.init(mesh_id); }
+        void init(glm::vec3 pos, const char* mesh_id) { m_pos = pos; m_mesh.init(mesh_id); m_world_triangles.clear(); }
+        void init(glm::vec3 pos, const std::string& mesh_id) { m_pos = pos; m_mesh.init(mesh_id); m_world_triangles.clear(); }
         
         /**
          * access attributes
@@ -94,57 +97,157 @@ namespace Engine3D
         glm::vec3& scale()          { return m_scale; }
         const glm::vec3& get_scale() const { return m_scale; }
         const Material* material()  { return m_mesh.material(); }
+        VertexFormat vertexFormat() { return m_mesh.vertexFormat(); }
+
+        /**
+         * check if the mesh is loaded, objects still loading aren't drawn
+         */
+        bool ready() const { return m_mesh.ready(); }
         
         const std::vector<Engine3D::Vertex>* vertices() { return m_mesh.vertices(); }
+        const std::vector<u32>*              indices()  { return m_mesh.indices(); }
 
-        std::vector<Engine3D::Triangle> triangles()
-        {
-            std::vector<Engine3D::Triangle> triangles{};
-            const std::vector<Engine3D::Vertex>* vertices = this->vertices();
-            if (vertices->size() != 0)
-            {
-                for (Engine3D::u32 i = 0; i < vertices->size(); i += 3)
-                {
-                    triangles.push_back(this->constructTriangle(i));
-                }
-            }
-
-            return triangles;
-        }
+        /**
+         * get all triangles of the collision mesh in world space, they are cached until pos(), rot() or scale() change
+         */
+        const std::vector<Engine3D::Triangle>& triangles();
         
-
         /**
-         * get bounding box
+         * get bounding box, it is empty until the mesh is loaded, doesn't wait for the mesh
          */
         Engine3D::Box boundingBox() 
         { 
         	return Engine3D::Box
         	(
         		m_pos, 
-        		m_scale * glm::vec3(2.0f * m_mesh.rawVertices()->furthest_vertex_value)
+        		m_scale * glm::vec3(2.0f * m_mesh.radius())
         	); 
         }
 
-        Engine3D::Box getDivisionBox(u32 x, u32 y, u32 z)
-        {
-            return Engine3D::Box(m_pos, m_scale);
+        /**
+         * get simplified triangles of the mesh the collisions are tested against, in mesh space
+         */
+        const CollisionMesh& collisionMesh() { return m_mesh.collisionMesh(); }
 
-            //glm::vec3 translated_pos = (glm::vec3(x, y, z) / float(DivisionFactor)) + (1.0f / DivisionFactor) / 2.0f;
-            //return Engine3D::Box(m_pos + translated_pos, glm::vec3(1.0f / DivisionFactor));
-        }
+        /**
+         * get bounding volume hierarchy of the collision mesh, boxes are in mesh space
+         */
+        const BoundingVolumeHierarchy& bvh() { return m_mesh.bvh(); }
+
+        /**
+         * get convex hull of the collision mesh in mesh space
+         */
+        const ConvexHull& hull() { return m_mesh.hull(); }
+
+        /**
+         * transform of the object derived from pos(), rot() and scale()
+         *
+         * world = pos + (rotation * local) * scale
+         */
+        struct Transform
+        {
+            glm::mat3 rotation     { 1 };
+            glm::mat3 inv_rotation { 1 };
+            glm::mat3 abs_rotation { 1 };
+            glm::vec3 inv_scale    { 1, 1, 1 };
+            u32       version      { 1 };
+        };
 
-        const std::vector<u32>& getDivision(u32 x, u32 y, u32 z)
+        /**
+         * get the cached transform, it is recalculated only if pos(), rot() or scale() changed
+         * since the last call
+         */
+        const Transform& transform() const
         {
-            if (x >= DivisionFactor || y >= DivisionFactor || z >= DivisionFactor)
+            if (m_pos != m_cached_pos || m_rot != m_cached_rot || m_scale != m_cached_scale)
             {
-                return { };
+                updateTransform();
             }
 
-            return m_mesh.rawVertices()->partitions[x + DivisionFactor * (y + DivisionFactor * z)];
+            return m_transform;
         }
 
         /**
-         * deletes the data saved in ram
+         * transform point from mesh space into world space and back
+         */
+        glm::vec3 localToWorld(const glm::vec3& point) const
+        {
+            return m_pos + (transform().rotation * point) * m_scale;
+        }
+        glm::vec3 worldToLocal(const glm::vec3& point) const
+        {
+            const Transform& t = transform();
+            return t.inv_rotation * ((point - m_pos) * t.inv_scale);
+        }
+
+        /**
+         * transform box from world space into mesh space and back,
+         * the result is the box around the transformed box
+         */
+        BoundingBox worldToLocal(const BoundingBox& box) const
+        {
+            const Transform& t = transform();
+
+            glm::vec3 center  = t.inv_rotation * (((box.min + box.max) * 0.5f - m_pos) * t.inv_scale);
+            glm::vec3 extents = glm::transpose(t.abs_rotation) * (((box.max - box.min) * 0.5f) * glm::abs(t.inv_scale));
+
+            return BoundingBox(center - extents, center + extents);
+        }
+        BoundingBox localToWorld(const BoundingBox& box) const
+        {
+            const Transform& t = transform();
+
+            glm::vec3 center  = m_pos + (t.rotation * ((box.min + box.max) * 0.5f)) * m_scale;
+            glm::vec3 extents = (t.abs_rotation * ((box.max - box.min) * 0.5f)) * glm::abs(m_scale);
+
+            return BoundingBox(center - extents, center + extents);
+        }
+
+        /**
+         * visit triangles of the collision mesh that may overlap the box in world space
+         *
+         * \arg callback - void(const Triangle&) or bool(const Triangle&) taking the triangle in world space,
+         *                 returning false stops the query
+         */
+        template<typename F>
+        void queryTriangles(const BoundingBox& box, F&& callback)
+        {
+            const CollisionMesh& collision = collisionMesh();
+
+            collision.bvh.queryBox(worldToLocal(box), [&](u32 triangle)
+                {
+                    return callback(worldTriangle(triangle, collision));
+                });
+        }
+
+        /**
+         * visit triangles of the collision mesh that may be crossed by the segment from ray.pos to ray.pos + ray.dir in world space
+         *
+         * \arg callback - void(const Triangle&) or bool(const Triangle&) taking the triangle in world space,
+         *                 returning false stops the query
+         */
+        template<typename F>
+        void queryTriangles(const Ray& ray, F&& callback)
+        {
+            const CollisionMesh& collision = collisionMesh();
+            const Transform&     t         = transform();
+
+            Ray local_ray(worldToLocal(ray.pos), t.inv_rotation * (ray.dir * t.inv_scale));
+
+            collision.bvh.queryRay(local_ray, [&](u32 triangle)
+                {
+                    return callback(worldTriangle(triangle, collision));
+                });
+        }
+
+        /**
+         * get the point of the mesh furthest in the direction, both in world space,
+         * climbs the hull from the previous answer if the mesh has one
+         */
+        glm::vec3 support(const glm::vec3& dir);
+
+        /**
+         * deletes the vertices saved in ram, collisions keep working on the collision mesh
          */
         void discardVertices() { m_mesh.discardVertices(); }
 
@@ -154,16 +257,34 @@ namespace Engine3D
         std::optional<Vertex> getVertex(u32 i);
 
         /**
-         * extract triangle from vertices
+         * extract triangle from the collision mesh in world space, the start is a position in its indices
          */
-        Triangle constructTriangle(u32 vert_index_start);
+        Triangle constructTriangle(u32 index_start);
 
         /**
-         * draw 3D object
+         * draw 3D object, the lod is picked from its size on screen
+         *
+         * \arg lod_scale - Game::lodScale() of the frame, the full mesh is drawn if it is 0
          */
-        void draw();
+        void draw(Camera& cam, float lod_scale);
     
     protected:
+
+        /**
+         * get size of the bounding box on screen in pixels
+         */
+        float screenSize(Camera& cam, float lod_scale);
+
+        /**
+         * recalculate the transform after pos(), rot() or scale() changed,
+         * cached world triangles become stale by bumping the version
+         */
+        void updateTransform() const;
+
+        /**
+         * get triangle in world space from the cache, transform it if it is stale
+         */
+        const Triangle& worldTriangle(u32 triangle, const CollisionMesh& collision);
     
         glm::vec3 m_pos     { 0 };
         glm::mat4 m_rot     { 1 };
@@ -172,5 +293,19 @@ namespace Engine3D
         Texture   m_texture;
 
         Engine3D::Mesh m_mesh;
+
+        //transform cache, compared against the attributes to find out whether they changed
+        mutable glm::vec3 m_cached_pos   { 0 };
+        mutable glm::mat4 m_cached_rot   { 1 };
+        mutable glm::vec3 m_cached_scale { 1, 1, 1 };
+        mutable Transform m_transform;
+
+        //world triangles, valid if their stamp equals the transform version and the mesh wasn't reloaded since
+        mutable std::vector<Triangle> m_world_triangles;
+        mutable std::vector<u32>      m_world_triangle_stamps;
+        mutable u32                   m_world_triangles_mesh_version { 0 };
+
+        //hull vertex returned by the last support query
+        u32 m_support_vertex { 0 };
     };
 };
\ No newline at end of file
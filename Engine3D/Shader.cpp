@@ -19,6 +19,7 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 #include <stdexcept>
 
 #include "Macros.hpp"
+#include "ShaderFile.hpp"
 
 #include <GL/glew.h>
 
@@ -80,26 +81,26 @@ namespace Engine3D
      */
     u32 cacheFragmentLoadingFunction(File& input_file)
     {
-        return compileFragmentShader(reinterpret_cast<const char*>(&input_file.readText()[0]));
+        return compileFragmentShader(ShaderFile::load(input_file).c_str());
     }
     void cacheFragmentClearFunction(u32& program)
     {
         if(program != -1) { glDeleteShader(program); }
     }
-    Cache<u32> g_fragment_program_cache(cacheFragmentLoadingFunction, cacheFragmentClearFunction);
+    Cache<u32> g_fragment_program_cache("fragment shaders", cacheFragmentLoadingFunction, cacheFragmentClearFunction);
     
     /**
      * vertex program cache manager
      */
     u32 cacheVertexLoadingFunction(File& input_file)
     {
-        return compileVertexShader(reinterpret_cast<const char*>(&input_file.readText()[0]));
+        return compileVertexShader(ShaderFile::load(input_file).c_str());
     }
     void cacheVertexClearFunction(u32& program)
     {
         if(program != -1) { glDeleteShader(program); }
     }
-    Cache<u32> g_vertex_program_cache(cacheVertexLoadingFunction, cacheVertexClearFunction);
+    Cache<u32> g_vertex_program_cache("vertex shaders", cacheVertexLoadingFunction, cacheVertexClearFunction);
     
     /**
      * constructors
@@ -137,19 +138,12 @@ namespace Engine3D
     {
         if(m_program != -1)
         {
-            if(!m_vertex_id.empty()) 
-            {
-                glDetachShader(m_program, *g_vertex_program_cache.get(m_vertex_id));
-                g_vertex_program_cache.del(m_vertex_id);
-            }
-            if(!m_fragment_id.empty()) 
-            { 
-                glDetachShader(m_program, *g_fragment_program_cache.get(m_vertex_id));
-                g_fragment_program_cache.del(m_fragment_id);
-            }
-
+            //deleting the program detaches the shaders
             glDeleteProgram(m_program);
         }
+
+        g_vertex_program_cache.del(m_vertex);
+        g_fragment_program_cache.del(m_fragment);
     }
     
     /**
@@ -157,6 +151,12 @@ namespace Engine3D
      */
     void Shader::use()
     {
+        //shader files changed on the disk are reloaded by the caches
+        if (m_program != -1 && (g_vertex_program_cache.version(m_vertex) != m_vertex_version || g_fragment_program_cache.version(m_fragment) != m_fragment_version))
+        {
+            link(*g_vertex_program_cache.peek(m_vertex), *g_fragment_program_cache.peek(m_fragment));
+        }
+
         glUseProgram(m_program);
         m_free_texture = 0;
     }
@@ -175,8 +175,11 @@ namespace Engine3D
      */
     void Shader::init(const char* vertex_shader_path, const char* fragment_shader_path)
     {
-        u32 vertex_shader   = *g_vertex_program_cache.get(vertex_shader_path);
-        u32 fragment_shader = *g_fragment_program_cache.get(fragment_shader_path);
+        m_vertex   = g_vertex_program_cache.get(vertex_shader_path);
+        m_fragment = g_fragment_program_cache.get(fragment_shader_path);
+
+        u32 vertex_shader   = *g_vertex_program_cache.peek(m_vertex);
+        u32 fragment_shader = *g_fragment_program_cache.peek(m_fragment);
         
         if(vertex_shader == -1 || fragment_shader == -1)
         {
@@ -185,7 +188,28 @@ namespace Engine3D
         }
         
         m_program = glCreateProgram();
-        
+
+        link(vertex_shader, fragment_shader);
+    }
+
+    /**
+     * attach the shaders and link the program, the shaders attached before are detached
+     */
+    void Shader::link(u32 vertex_shader, u32 fragment_shader)
+    {
+        u32 attached[2];
+        int attached_count = 0;
+
+        glGetAttachedShaders(m_program, 2, &attached_count, attached);
+
+        for (int i = 0; i < attached_count; i++)
+        {
+            glDetachShader(m_program, attached[i]);
+        }
+
+        m_vertex_version   = g_vertex_program_cache.version(m_vertex);
+        m_fragment_version = g_fragment_program_cache.version(m_fragment);
+
         glAttachShader(m_program, vertex_shader);
         glAttachShader(m_program, fragment_shader);
         glLinkProgram(m_program);
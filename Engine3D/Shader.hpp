@@ -64,7 +64,7 @@ namespace Engine3D
        ~Shader();
 
         /**
-         * state that we wanto to use this program
+         * state that we wanto to use this program, the program is linked again if its shader files were reloaded
          */
         void use();
         
@@ -101,9 +101,16 @@ namespace Engine3D
         u32 getAttributeIndex(const char* attribute_name) const;
         
     private:
+
+        /**
+         * attach the shaders and link the program
+         */
+        void link(u32 vertex_shader, u32 fragment_shader);
     
-        std::string m_fragment_id;
-        std::string m_vertex_id;
+        CacheHandle<u32> m_fragment;
+        CacheHandle<u32> m_vertex;
+        u32 m_fragment_version { 0 };
+        u32 m_vertex_version   { 0 };
         int m_program { -1 };
 
         u32 m_free_texture { 0 };
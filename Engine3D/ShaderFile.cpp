@@ -0,0 +1,131 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "ShaderFile.hpp"
+
+#include <filesystem>
+
+namespace Engine3D
+{
+    /**
+     * read source of the shader, the cooked shader is used while it is newer than the source
+     */
+    std::string ShaderFile::load(File& input_file)
+    {
+        const std::string& path = input_file.getPath();
+
+        if (cookedUpToDate(path))
+        {
+            File cooked(cookedPath(path));
+
+            if (cooked.isFile())
+            {
+                return cooked.readText();
+            }
+        }
+
+        return input_file.readText();
+    }
+
+    /**
+     * strip comments, indentation and empty lines out of the source
+     */
+    std::string ShaderFile::cook(const std::string& source)
+    {
+        std::string result;
+        std::string line;
+
+        result.reserve(source.size());
+
+        //append line without the indentation and the trailing spaces, skip it if it is empty
+        auto flush = [&]()
+        {
+            u64 begin = line.find_first_not_of(" \t\r");
+            u64 end   = line.find_last_not_of(" \t\r");
+
+            if (begin != std::string::npos)
+            {
+                result.append(line, begin, end - begin + 1);
+                result += '\n';
+            }
+
+            line.clear();
+        };
+
+        for (u64 i = 0; i < source.size(); i++)
+        {
+            if (source.compare(i, 2, "//") == 0)
+            {
+                i = source.find('\n', i);
+
+                if (i == std::string::npos)
+                {
+                    break;
+                }
+
+                flush();
+            }
+            else if (source.compare(i, 2, "/*") == 0)
+            {
+                u64 end = source.find("*/", i + 2);
+
+                //the comment separates the tokens around it
+                line += ' ';
+                i     = end == std::string::npos ? source.size() : end + 1;
+            }
+            else if (source[i] == '\n')
+            {
+                flush();
+            }
+            else
+            {
+                line += source[i];
+            }
+        }
+
+        flush();
+
+        return result;
+    }
+
+    /**
+     * get path of the cooked shader made from the source file
+     */
+    std::string ShaderFile::cookedPath(const std::string& path)
+    {
+        return path + Extension;
+    }
+
+    /**
+     * check if the cooked shader of the source file exists and isn't older than the source
+     */
+    bool ShaderFile::cookedUpToDate(const std::string& path)
+    {
+        //packs hold only the cooked shaders made when they were built
+        if (Pack::contains(cookedPath(path)))
+        {
+            return true;
+        }
+
+        std::error_code source_error;
+        std::error_code cooked_error;
+
+        auto source_time = std::filesystem::last_write_time(path, source_error);
+        auto cooked_time = std::filesystem::last_write_time(cookedPath(path), cooked_error);
+
+        return !source_error && !cooked_error && cooked_time >= source_time;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,56 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <string>
+
+#include "Types.hpp"
+#include "File.hpp"
+
+namespace Engine3D
+{
+    /**
+     * cooked shaders, the glsl is compiled by the driver so the cooked shader stays text
+     * without the comments, indentation and empty lines the compiler would skip
+     */
+    namespace ShaderFile
+    {
+        constexpr u32         Version   = 1; //of the rules of cook()
+        constexpr const char* Extension = ".e3dshader";
+
+        /**
+         * read source of the shader, the cooked shader is used while it is newer than the source
+         */
+        std::string load(File& input_file);
+
+        /**
+         * strip comments, indentation and empty lines out of the source
+         */
+        std::string cook(const std::string& source);
+
+        /**
+         * get path of the cooked shader made from the source file, the extension is appended
+         * since the vertex and the fragment shader of a program share the name
+         */
+        std::string cookedPath(const std::string& path);
+
+        /**
+         * check if the cooked shader of the source file exists and isn't older than the source
+         */
+        bool cookedUpToDate(const std::string& path);
+    };
+};
\ No newline at end of file
@@ -16,6 +16,8 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 */
 #pragma once
 
+#include "Types.hpp"
+
 namespace Engine3D
 {
     struct Box
@@ -91,6 +93,40 @@ namespace Engine3D
         glm::vec3 p3 { 0 };
     };
 
+    /**
+     * triangles stored as structure of arrays, so one instruction can work on all of them
+     */
+    struct TriangleBlock
+    {
+        static constexpr u32 Width = 8;
+
+        //x[0] are the x coordinates of the first points, x[1] of the second points...
+        alignas(32) float x[3][Width] {};
+        alignas(32) float y[3][Width] {};
+        alignas(32) float z[3][Width] {};
+
+        u32 count { 0 };
+
+        bool empty() const { return count == 0; }
+        bool full()  const { return count == Width; }
+        void clear()       { count = 0; }
+
+        void push(const Triangle& triangle)
+        {
+            x[0][count] = triangle.p1.x; y[0][count] = triangle.p1.y; z[0][count] = triangle.p1.z;
+            x[1][count] = triangle.p2.x; y[1][count] = triangle.p2.y; z[1][count] = triangle.p2.z;
+            x[2][count] = triangle.p3.x; y[2][count] = triangle.p3.y; z[2][count] = triangle.p3.z;
+            count++;
+        }
+
+        Triangle get(u32 i) const
+        {
+            return Triangle(glm::vec3(x[0][i], y[0][i], z[0][i]),
+                            glm::vec3(x[1][i], y[1][i], z[1][i]),
+                            glm::vec3(x[2][i], y[2][i], z[2][i]));
+        }
+    };
+
     struct Bean
     {
         Bean() {}
@@ -17,14 +17,17 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include <functional>
-#include <optional>
-#include <unordered_map>
+#include <stdexcept>
+#include <type_traits>
+#include <limits>
+#include <vector>
+#include <span>
+#include <cmath>
 
-#define GLM_ENABLE_EXPERIMENTAL
 #include <glm/glm.hpp>
-#include <glm/gtx/hash.hpp>
 
 #include "Types.hpp"
+#include "Shapes.hpp"
 
 
 namespace Engine3D
@@ -44,6 +47,12 @@ namespace Engine3D
 
     /**
      * structure that divides space into blocks and manages big number of objects in them
+     *
+     * cells are keyed by their packed integer coordinates and stored in an open addressing
+     * hash table (linear probing), the objects of all cells live in one contiguous pool
+     *
+     * every added object gets a handle, its record remembers where it sits in each cell
+     * so it can be removed or moved without scanning the cells
      */
     template <typename T>
     class SpatialPartition
@@ -52,25 +61,47 @@ namespace Engine3D
 
         static constexpr u32 DefaultCellSize = 16;
 
+        /**
+         * number of bits used for each packed cell coordinate
+         */
+        static constexpr u32 CoordBits = 21;
+        static constexpr u64 CoordMask = (u64(1) << CoordBits) - 1;
+
+        /**
+         * initial number of hash table slots, must be a power of 2
+         */
+        static constexpr u32 DefaultSlotCount = 64;
+
+        /**
+         * identifier of an object inside of the partition
+         */
+        using Handle = u32;
+        static constexpr Handle InvalidHandle = ~Handle(0);
+
+        /**
+         * view into the pool of objects belonging to one cell
+         */
+        using CellView = std::span<T* const>;
+
         /**
          * constructors
          */
-        SpatialPartition(u32 cell_size = DefaultCellSize) : m_cell_size(cell_size) {}
-        SpatialPartition(u32 cell_size, std::function<BoundingBox(const T&)> get_bounding_box) : m_get_bounding_box(std::move(get_bounding_box)) { }
+        SpatialPartition(u32 cell_size = DefaultCellSize) { init(cell_size); }
+        SpatialPartition(u32 cell_size, std::function<BoundingBox(const T&)> get_bounding_box) { init(cell_size, std::move(get_bounding_box)); }
 
         /**
          * explicit constructor
          */
         void init(u32 cell_size = DefaultCellSize)
         {
-            m_cells.clear();
-            m_cell_size = cell_size;
+            m_cell_size     = cell_size;
+            m_inv_cell_size = 1.0f / static_cast<float>(cell_size);
+            clear();
         }
         void init(u32 cell_size, std::function<BoundingBox(const T&)> get_bounding_box)
         {
-            m_cells.clear();
-            m_cell_size = cell_size;
-            m_get_bounding_box = get_bounding_box;
+            init(cell_size);
+            m_get_bounding_box = std::move(get_bounding_box);
         }
 
         /**
@@ -78,99 +109,209 @@ namespace Engine3D
          */
         void clear()
         {
-            m_cells.clear();
+            m_slots.assign(DefaultSlotCount, Slot());
+            m_pool.clear();
+            m_pool_owners.clear();
+            m_records.clear();
+            m_stamps.clear();
+            m_free_records.clear();
+            m_cell_count   = 0;
+            m_pool_garbage = 0;
+        }
+
+        /**
+         * get bounding box of the object using the user specified function
+         */
+        BoundingBox boundingBox(const T& object) const
+        {
+            if (!m_get_bounding_box)
+            {
+                throw std::runtime_error("SpatialPartition::boundingBox() error: bounding box function not specified");
+            }
+
+            return m_get_bounding_box(object);
         }
 
         /**
          * add object into the space
          */
-        void add(const T* object)
+        Handle add(const T* object)
         {
             if (m_get_bounding_box)
             {
-                BoundingBox object_rect = m_get_bounding_box(*object);
-                
-                glm::vec3 cell_max = m_world_to_cell(object_rect.max);
-                glm::vec3 cell_min = m_world_to_cell(object_rect.min);
+                return add(object, m_get_bounding_box(*object));
+            }
+            else
+            {
+                throw std::runtime_error("SpatialPartition::add() error: bounding box function not specified");
+            }
+        }
+        Handle add(const T* object, const BoundingBox& box)
+        {
+            Handle handle;
 
-                for (s64 x = static_cast<s64>(cell_min.x); x < static_cast<s64>(cell_max.x) + 1; x++)
-                {
-                    for (s64 y = static_cast<s64>(cell_min.y); y < static_cast<s64>(cell_max.y) + 1; y++)
-                    {
-                        for (s64 z = static_cast<s64>(cell_min.z); z < static_cast<s64>(cell_max.z) + 1; z++)
-                        {
-                            u64 hash = m_hash_func(glm::vec3(x, y, z));
+            if (m_free_records.empty())
+            {
+                handle = static_cast<Handle>(m_records.size());
+                m_records.emplace_back();
+                m_stamps.push_back(0);
+            }
+            else
+            {
+                handle = m_free_records.back();
+                m_free_records.pop_back();
+            }
 
-                            auto it = m_cells.find(hash);
+            m_records[handle].object = const_cast<T*>(object);
 
-                            if (it == m_cells.end())
-                            {
-                                m_cells.emplace(hash, std::vector<T*>());
-                            }
+            glm::ivec3 cell_min, cell_max;
+            boxToCells(box, cell_min, cell_max);
 
-                            m_cells[hash].push_back(const_cast<T*>(object));
-                        }
+            for (s32 z = cell_min.z; z <= cell_max.z; z++)
+            {
+                for (s32 y = cell_min.y; y <= cell_max.y; y++)
+                {
+                    for (s32 x = cell_min.x; x <= cell_max.x; x++)
+                    {
+                        insertIntoCell(handle, packCell(x, y, z));
                     }
                 }
             }
-            else
-            {
-                throw std::runtime_error("SpatialPartition::add() error: bounding box function not specified");
-            }
+
+            return handle;
         }
 
         /**
          * delete object from space
          */
+        void del(Handle handle)
+        {
+            if (handle >= m_records.size() || m_records[handle].object == nullptr)
+            {
+                return;
+            }
+
+            Record& record = m_records[handle];
+
+            while (!record.memberships.empty())
+            {
+                removeFromCell(handle, static_cast<u32>(record.memberships.size() - 1));
+            }
+
+            record.object = nullptr;
+            m_free_records.push_back(handle);
+
+            compactPool();
+        }
         void del(const T* object)
         {
-            if (m_get_bounding_box)
+            Handle handle = find(object);
+
+            if (handle != InvalidHandle)
             {
-                BoundingBox object_rect = m_get_bounding_box(*object);
+                del(handle);
+            }
+        }
 
-                glm::vec3 cell_max = m_world_to_cell(object_rect.max);
-                glm::vec3 cell_min = m_world_to_cell(object_rect.min);
+        /**
+         * find handle of the object by looking into the cells its bounding box covers
+         */
+        Handle find(const T* object) const
+        {
+            if (!m_get_bounding_box)
+            {
+                throw std::runtime_error("SpatialPartition::find() error: bounding box function not specified");
+            }
+
+            glm::ivec3 cell_min, cell_max;
+            boxToCells(m_get_bounding_box(*object), cell_min, cell_max);
 
-                for (s32 x = cell_min.x; x < cell_max.x + 1; x++)
+            for (s32 z = cell_min.z; z <= cell_max.z; z++)
+            {
+                for (s32 y = cell_min.y; y <= cell_max.y; y++)
                 {
-                    for (s32 y = cell_min.y; y < cell_max.y + 1; y++)
+                    for (s32 x = cell_min.x; x <= cell_max.x; x++)
                     {
-                        for (s32 z = cell_min.z; z < cell_max.z + 1; z++)
-                        {
-                            u64 hash = m_hash_func(glm::vec3(x, y, z));
+                        u32 slot_index = findCell(packCell(x, y, z));
 
-                            auto cell = m_cells.find(hash);
+                        if (slot_index == NotFound)
+                        {
+                            continue;
+                        }
 
-                            if (cell != m_cells.end())
-                            {
-                                for (auto it = cell->second.begin(); it != cell->second.end(); it++)
-                                {
-                                    if (*it == object)
-                                    {
-                                        cell->second.erase(it);
-                                        break;
-                                    }
-                                }
-                            }
+                        const Slot& cell = m_slots[slot_index];
 
-                            if (cell->second.size() == 0)
+                        for (u32 i = 0; i < cell.size; i++)
+                        {
+                            if (m_pool[cell.offset + i] == object)
                             {
-                                m_cells.erase(hash);
+                                return m_pool_owners[cell.offset + i].handle;
                             }
                         }
                     }
                 }
             }
-            else
+
+            return InvalidHandle;
+        }
+
+        /**
+         * move object from old bounding box to the new one, only cells
+         * whose membership changed are touched
+         *
+         * \arg old_box - bounding box the object was added or last moved with
+         */
+        void move(Handle handle, const BoundingBox& old_box, const BoundingBox& new_box)
+        {
+            if (handle >= m_records.size() || m_records[handle].object == nullptr)
+            {
+                return;
+            }
+
+            glm::ivec3 old_min, old_max;
+            glm::ivec3 new_min, new_max;
+            boxToCells(old_box, old_min, old_max);
+            boxToCells(new_box, new_min, new_max);
+
+            // still covering the same cells
+            if (old_min == new_min && old_max == new_max)
             {
-                throw std::runtime_error("SpatialPartition::del() error: bounding box function not specified");
+                return;
             }
+
+            // leave the cells outside of the new range
+            std::vector<Membership>& memberships = m_records[handle].memberships;
+
+            for (u32 i = static_cast<u32>(memberships.size()); i-- > 0;)
+            {
+                if (!inRange(unpackCell(memberships[i].key), new_min, new_max))
+                {
+                    removeFromCell(handle, i);
+                }
+            }
+
+            // enter the cells outside of the old range
+            for (s32 z = new_min.z; z <= new_max.z; z++)
+            {
+                for (s32 y = new_min.y; y <= new_max.y; y++)
+                {
+                    for (s32 x = new_min.x; x <= new_max.x; x++)
+                    {
+                        if (!inRange(glm::ivec3(x, y, z), old_min, old_max))
+                        {
+                            insertIntoCell(handle, packCell(x, y, z));
+                        }
+                    }
+                }
+            }
+
+            compactPool();
         }
 
         /**
          * update cells
          *
-         * \note - slow
+         * \note - slow, rebuilds the whole structure, handles are reassigned in order of the objects
          */
         void update(const std::vector<T>& objects)
         {
@@ -210,7 +351,7 @@ namespace Engine3D
          */
         BoundingBox getCell(const glm::vec3& pos)
         {
-            glm::vec3 cell_pos = m_world_to_cell(pos);
+            glm::vec3 cell_pos = glm::vec3(worldToCell(pos));
 
             return { cell_pos * static_cast<float>(m_cell_size), (cell_pos + 1.0f) * static_cast<float>(m_cell_size) };
         }
@@ -225,34 +366,568 @@ namespace Engine3D
 
         /**
          * get the objects within a certain cell
+         *
+         * \note - the view is invalidated by the next add(), del() or move()
          */
-        const std::vector<T*>* get(const glm::vec3& pos)
+        CellView get(const glm::vec3& pos) const
         {
-            glm::vec3 cell_pos = m_world_to_cell(pos);
+            glm::ivec3 cell_pos   = worldToCell(pos);
+            u32        slot_index = findCell(packCell(cell_pos.x, cell_pos.y, cell_pos.z));
 
-            auto cell = m_cells.find(m_hash_func(cell_pos));
+            if (slot_index == NotFound)
+            {
+                return {};
+            }
+
+            const Slot& cell = m_slots[slot_index];
+
+            return CellView(m_pool.data() + cell.offset, cell.size);
+        }
+
+        /**
+         * visit every object in the cells overlapped by the box, each object only once
+         *
+         * \arg callback - void(T*) or bool(T*), returning false stops the query
+         *
+         * \note - the partition must not be modified from inside of the callback
+         */
+        template<typename F>
+        void queryBox(const BoundingBox& box, F&& callback) const
+        {
+            glm::ivec3 cell_min, cell_max;
+            boxToCells(box, cell_min, cell_max);
 
-            if (cell == m_cells.end())
+            beginQuery();
+
+            for (s32 z = cell_min.z; z <= cell_max.z; z++)
             {
-                return nullptr;
+                for (s32 y = cell_min.y; y <= cell_max.y; y++)
+                {
+                    for (s32 x = cell_min.x; x <= cell_max.x; x++)
+                    {
+                        if (!visitCell(packCell(x, y, z), callback))
+                        {
+                            return;
+                        }
+                    }
+                }
             }
-            else
+        }
+        u32 queryBox(const BoundingBox& box, T** result, u32 capacity) const
+        {
+            u32 count = 0;
+            if (capacity == 0)
             {
-                return &cell->second;
+                return count;
             }
+            queryBox(box, [&](T* object) { result[count++] = object; return count < capacity; });
+            return count;
+        }
+
+        /**
+         * visit every object in the cells overlapped by the sphere, each object only once
+         *
+         * \arg callback - void(T*) or bool(T*), returning false stops the query
+         *
+         * \note - the partition must not be modified from inside of the callback
+         */
+        template<typename F>
+        void querySphere(const glm::vec3& center, float radius, F&& callback) const
+        {
+            glm::ivec3 cell_min, cell_max;
+            boxToCells(BoundingBox(center - radius, center + radius), cell_min, cell_max);
+
+            float cell_size = static_cast<float>(m_cell_size);
+
+            beginQuery();
+
+            for (s32 z = cell_min.z; z <= cell_max.z; z++)
+            {
+                for (s32 y = cell_min.y; y <= cell_max.y; y++)
+                {
+                    for (s32 x = cell_min.x; x <= cell_max.x; x++)
+                    {
+                        // skip corner cells the sphere doesn't reach
+                        glm::vec3 cell_corner  = glm::vec3(x, y, z) * cell_size;
+                        glm::vec3 closest      = glm::clamp(center, cell_corner, cell_corner + cell_size);
+                        glm::vec3 center_delta = closest - center;
+
+                        if (glm::dot(center_delta, center_delta) > radius * radius)
+                        {
+                            continue;
+                        }
+
+                        if (!visitCell(packCell(x, y, z), callback))
+                        {
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+        u32 querySphere(const glm::vec3& center, float radius, T** result, u32 capacity) const
+        {
+            u32 count = 0;
+            if (capacity == 0)
+            {
+                return count;
+            }
+            querySphere(center, radius, [&](T* object) { result[count++] = object; return count < capacity; });
+            return count;
+        }
+
+        /**
+         * visit every object in the cells crossed by the segment from ray.pos to ray.pos + ray.dir,
+         * cells are walked in order along the ray (3D-DDA), each object is visited only once
+         *
+         * \arg callback - void(T*) or bool(T*), returning false stops the query
+         *
+         * \note - the partition must not be modified from inside of the callback
+         */
+        template<typename F>
+        void queryRay(const Ray& ray, F&& callback) const
+        {
+            // work in cell space, where every cell is 1x1x1
+            glm::vec3  start = ray.pos * m_inv_cell_size;
+            glm::vec3  delta = ray.dir * m_inv_cell_size;
+            glm::ivec3 cell  = worldToCell(ray.pos);
+            glm::ivec3 last  = worldToCell(ray.pos + ray.dir);
+
+            glm::ivec3 step;
+            glm::vec3  t_max;
+            glm::vec3  t_delta;
+
+            for (u32 axis = 0; axis < 3; axis++)
+            {
+                if (delta[axis] > 0)
+                {
+                    step[axis]    = 1;
+                    t_max[axis]   = (static_cast<float>(cell[axis] + 1) - start[axis]) / delta[axis];
+                    t_delta[axis] = 1.0f / delta[axis];
+                }
+                else if (delta[axis] < 0)
+                {
+                    step[axis]    = -1;
+                    t_max[axis]   = (static_cast<float>(cell[axis]) - start[axis]) / delta[axis];
+                    t_delta[axis] = -1.0f / delta[axis];
+                }
+                else
+                {
+                    step[axis]    = 0;
+                    t_max[axis]   = std::numeric_limits<float>::infinity();
+                    t_delta[axis] = std::numeric_limits<float>::infinity();
+                }
+            }
+
+            // the walk can never take more steps than the manhattan distance between the end cells
+            glm::ivec3 cell_span = glm::abs(last - cell);
+            u32        steps     = static_cast<u32>(cell_span.x + cell_span.y + cell_span.z);
+
+            beginQuery();
+
+            for (u32 i = 0; ; i++)
+            {
+                if (!visitCell(packCell(cell.x, cell.y, cell.z), callback))
+                {
+                    return;
+                }
+
+                if (i == steps)
+                {
+                    return;
+                }
+
+                // advance along the axis whose cell boundary is crossed first
+                u32 axis = t_max.x < t_max.y ? (t_max.x < t_max.z ? 0 : 2) : (t_max.y < t_max.z ? 1 : 2);
+
+                cell[axis]  += step[axis];
+                t_max[axis] += t_delta[axis];
+            }
+        }
+        u32 queryRay(const Ray& ray, T** result, u32 capacity) const
+        {
+            u32 count = 0;
+            if (capacity == 0)
+            {
+                return count;
+            }
+            queryRay(ray, [&](T* object) { result[count++] = object; return count < capacity; });
+            return count;
         }
 
     private:
 
-        std::hash<glm::vec3> m_hash_func {};
+        static constexpr u64 EmptyKey = ~u64(0);
+        static constexpr u32 NotFound = ~u32(0);
+
+        /**
+         * hash table slot, owns range [offset, offset + capacity) of the pool
+         */
+        struct Slot
+        {
+            u64 key      { EmptyKey };
+            u32 offset   { 0 };
+            u32 size     { 0 };
+            u32 capacity { 0 };
+        };
 
-        std::function<glm::vec3(const glm::vec3&)> m_world_to_cell = [this](const glm::vec3& pos) -> glm::vec3
+        /**
+         * one cell the object is in and its index inside of that cell
+         */
+        struct Membership
         {
-            return glm::vec3(floor(pos.x / m_cell_size), floor(pos.y / m_cell_size), floor(pos.z / m_cell_size));
+            u64 key;
+            u32 index;
         };
 
-        std::unordered_map<u64, std::vector<T*>> m_cells;
-        u32                           m_cell_size;
+        /**
+         * back reference from the pool to the record and its membership
+         */
+        struct Owner
+        {
+            Handle handle;
+            u32    membership;
+        };
+
+        /**
+         * object registered in the partition
+         */
+        struct Record
+        {
+            T*                      object { nullptr };
+            std::vector<Membership> memberships;
+        };
+
+        /**
+         * convert world position into integer cell coordinates
+         */
+        glm::ivec3 worldToCell(const glm::vec3& pos) const
+        {
+            return glm::ivec3(static_cast<s32>(std::floor(pos.x * m_inv_cell_size)),
+                              static_cast<s32>(std::floor(pos.y * m_inv_cell_size)),
+                              static_cast<s32>(std::floor(pos.z * m_inv_cell_size)));
+        }
+        void boxToCells(const BoundingBox& box, glm::ivec3& cell_min, glm::ivec3& cell_max) const
+        {
+            cell_min = worldToCell(box.min);
+            cell_max = worldToCell(box.max);
+        }
+        static bool inRange(const glm::ivec3& cell, const glm::ivec3& cell_min, const glm::ivec3& cell_max)
+        {
+            return cell.x >= cell_min.x && cell.x <= cell_max.x &&
+                   cell.y >= cell_min.y && cell.y <= cell_max.y &&
+                   cell.z >= cell_min.z && cell.z <= cell_max.z;
+        }
+
+        /**
+         * pack 3 cell coordinates into one key, 21 bits (two's complement) per axis
+         */
+        static u64 packCell(s32 x, s32 y, s32 z)
+        {
+            return (static_cast<u64>(static_cast<u32>(x)) & CoordMask) |
+                   (static_cast<u64>(static_cast<u32>(y)) & CoordMask) << CoordBits |
+                   (static_cast<u64>(static_cast<u32>(z)) & CoordMask) << (CoordBits * 2);
+        }
+        static glm::ivec3 unpackCell(u64 key)
+        {
+            // shift the 21 bit field to the top and back to sign extend it
+            auto coord = [](u64 field) { return static_cast<s32>(static_cast<u32>(field << (32 - CoordBits))) >> (32 - CoordBits); };
+
+            return glm::ivec3(coord(key & CoordMask), coord((key >> CoordBits) & CoordMask), coord((key >> (CoordBits * 2)) & CoordMask));
+        }
+
+        /**
+         * start a new query, objects already visited in this query are marked with the stamp
+         */
+        void beginQuery() const
+        {
+            if (++m_query_stamp == 0)
+            {
+                std::fill(m_stamps.begin(), m_stamps.end(), 0);
+                m_query_stamp = 1;
+            }
+        }
+
+        /**
+         * pass objects of the cell not yet visited in the current query to the callback
+         *
+         * \return false if the callback asked to stop the query
+         */
+        template<typename F>
+        bool visitCell(u64 key, F& callback) const
+        {
+            u32 slot_index = findCell(key);
+
+            if (slot_index == NotFound)
+            {
+                return true;
+            }
+
+            const Slot& cell = m_slots[slot_index];
+
+            for (u32 i = cell.offset; i < cell.offset + cell.size; i++)
+            {
+                u32& stamp = m_stamps[m_pool_owners[i].handle];
+
+                if (stamp == m_query_stamp)
+                {
+                    continue;
+                }
+                stamp = m_query_stamp;
+
+                if constexpr (std::is_same_v<std::invoke_result_t<F&, T*>, bool>)
+                {
+                    if (!callback(m_pool[i]))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    callback(m_pool[i]);
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * fibonacci hashing of the packed key into the slot table
+         */
+        u32 homeSlot(u64 key) const
+        {
+            return static_cast<u32>((key * 0x9E3779B97F4A7C15ull) >> 32) & static_cast<u32>(m_slots.size() - 1);
+        }
+
+        /**
+         * find slot index of a cell or NotFound
+         */
+        u32 findCell(u64 key) const
+        {
+            u32 mask = static_cast<u32>(m_slots.size() - 1);
+
+            for (u32 i = homeSlot(key); ; i = (i + 1) & mask)
+            {
+                if (m_slots[i].key == key)      { return i; }
+                if (m_slots[i].key == EmptyKey) { return NotFound; }
+            }
+        }
+
+        /**
+         * find a cell or create an empty one
+         */
+        Slot& findOrInsertCell(u64 key)
+        {
+            // keep the load factor under 1/2 so the probe sequences stay short
+            if ((m_cell_count + 1) * 2 > m_slots.size())
+            {
+                rehash(static_cast<u32>(m_slots.size() * 2));
+            }
+
+            u32 mask = static_cast<u32>(m_slots.size() - 1);
+
+            for (u32 i = homeSlot(key); ; i = (i + 1) & mask)
+            {
+                if (m_slots[i].key == key)
+                {
+                    return m_slots[i];
+                }
+                if (m_slots[i].key == EmptyKey)
+                {
+                    m_slots[i].key = key;
+                    m_cell_count++;
+                    return m_slots[i];
+                }
+            }
+        }
+
+        /**
+         * append object to the cell and remember its position in the record
+         */
+        void insertIntoCell(Handle handle, u64 key)
+        {
+            Slot& cell = findOrInsertCell(key);
+
+            if (cell.size == cell.capacity)
+            {
+                growCell(cell);
+            }
+
+            std::vector<Membership>& memberships = m_records[handle].memberships;
+
+            m_pool[cell.offset + cell.size]        = m_records[handle].object;
+            m_pool_owners[cell.offset + cell.size] = { handle, static_cast<u32>(memberships.size()) };
+            memberships.push_back({ key, cell.size });
+
+            cell.size++;
+        }
+
+        /**
+         * remove one membership of the object, swap and pop in both the cell and the record
+         */
+        void removeFromCell(Handle handle, u32 membership_index)
+        {
+            std::vector<Membership>& memberships = m_records[handle].memberships;
+            Membership               membership  = memberships[membership_index];
+
+            u32   slot_index = findCell(membership.key);
+            Slot& cell       = m_slots[slot_index];
+
+            // move the last object of the cell into the freed place
+            u32 last = --cell.size;
+            if (membership.index != last)
+            {
+                Owner moved = m_pool_owners[cell.offset + last];
+
+                m_pool[cell.offset + membership.index]        = m_pool[cell.offset + last];
+                m_pool_owners[cell.offset + membership.index] = moved;
+                m_records[moved.handle].memberships[moved.membership].index = membership.index;
+            }
+
+            // move the last membership of the record into the freed place
+            u32 last_membership = static_cast<u32>(memberships.size() - 1);
+            if (membership_index != last_membership)
+            {
+                Membership moved = memberships[last_membership];
+                memberships[membership_index] = moved;
+
+                u32 moved_slot_index = findCell(moved.key);
+                m_pool_owners[m_slots[moved_slot_index].offset + moved.index].membership = membership_index;
+            }
+            memberships.pop_back();
+
+            if (cell.size == 0)
+            {
+                eraseCell(slot_index);
+            }
+        }
+
+        /**
+         * remove cell with backward shift deletion, so no tombstones are needed
+         */
+        void eraseCell(u32 slot_index)
+        {
+            u32 mask = static_cast<u32>(m_slots.size() - 1);
+
+            m_pool_garbage += m_slots[slot_index].capacity;
+            m_cell_count--;
+
+            u32 hole = slot_index;
+            for (u32 i = (hole + 1) & mask; m_slots[i].key != EmptyKey; i = (i + 1) & mask)
+            {
+                u32 home = homeSlot(m_slots[i].key);
+
+                // move the entry into the hole if the hole lies on its probe path
+                if (((i - home) & mask) >= ((i - hole) & mask))
+                {
+                    m_slots[hole] = m_slots[i];
+                    hole          = i;
+                }
+            }
+
+            m_slots[hole] = Slot();
+        }
+
+        /**
+         * resize the hash table, cell ranges in the pool stay untouched
+         */
+        void rehash(u32 slot_count)
+        {
+            std::vector<Slot> old_slots(slot_count, Slot());
+            std::swap(old_slots, m_slots);
+
+            u32 mask = slot_count - 1;
+
+            for (const Slot& slot : old_slots)
+            {
+                if (slot.key == EmptyKey)
+                {
+                    continue;
+                }
+
+                u32 i = homeSlot(slot.key);
+                while (m_slots[i].key != EmptyKey)
+                {
+                    i = (i + 1) & mask;
+                }
+                m_slots[i] = slot;
+            }
+        }
+
+        /**
+         * make room for one more object in the cell
+         */
+        void growCell(Slot& cell)
+        {
+            u32 new_capacity = cell.capacity == 0 ? 4 : cell.capacity * 2;
+
+            // the cell is at the end of the pool -> grow in place
+            if (cell.capacity != 0 && cell.offset + cell.capacity == m_pool.size())
+            {
+                m_pool.resize(cell.offset + new_capacity);
+                m_pool_owners.resize(cell.offset + new_capacity);
+            }
+            // relocate the cell to the end of the pool
+            else
+            {
+                u32 new_offset = static_cast<u32>(m_pool.size());
+                m_pool.resize(new_offset + new_capacity);
+                m_pool_owners.resize(new_offset + new_capacity);
+                std::copy(m_pool.begin() + cell.offset, m_pool.begin() + cell.offset + cell.size, m_pool.begin() + new_offset);
+                std::copy(m_pool_owners.begin() + cell.offset, m_pool_owners.begin() + cell.offset + cell.size, m_pool_owners.begin() + new_offset);
+
+                m_pool_garbage += cell.capacity;
+                cell.offset     = new_offset;
+            }
+
+            cell.capacity = new_capacity;
+        }
+
+        /**
+         * squeeze out ranges left behind by relocated or deleted cells,
+         * indices inside of the cells stay the same so the records remain valid
+         */
+        void compactPool()
+        {
+            if (m_pool_garbage < 1024 || m_pool_garbage * 2 < m_pool.size())
+            {
+                return;
+            }
+
+            std::vector<T*>   pool;
+            std::vector<Owner> pool_owners;
+            pool.reserve(m_pool.size() - m_pool_garbage);
+            pool_owners.reserve(m_pool.size() - m_pool_garbage);
+
+            for (Slot& slot : m_slots)
+            {
+                if (slot.key == EmptyKey)
+                {
+                    continue;
+                }
+
+                u32 new_offset = static_cast<u32>(pool.size());
+                pool.insert(pool.end(), m_pool.begin() + slot.offset, m_pool.begin() + slot.offset + slot.capacity);
+                pool_owners.insert(pool_owners.end(), m_pool_owners.begin() + slot.offset, m_pool_owners.begin() + slot.offset + slot.capacity);
+                slot.offset = new_offset;
+            }
+
+            m_pool         = std::move(pool);
+            m_pool_owners  = std::move(pool_owners);
+            m_pool_garbage = 0;
+        }
+
+        std::vector<Slot>                    m_slots;
+        std::vector<T*>                      m_pool;
+        std::vector<Owner>                   m_pool_owners;
+        std::vector<Record>                  m_records;
+        std::vector<Handle>                  m_free_records;
+        mutable std::vector<u32>             m_stamps;
+        mutable u32                          m_query_stamp   { 0 };
+        u32                                  m_cell_count    { 0 };
+        u32                                  m_pool_garbage  { 0 };
+        u32                                  m_cell_size     { DefaultCellSize };
+        float                                m_inv_cell_size { 1.0f / DefaultCellSize };
         std::function<BoundingBox(const T&)> m_get_bounding_box;
     };
 }
\ No newline at end of file
@@ -23,8 +23,11 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 #include <SDL2/SDL.h>
 
 
+#include <cstring>
+
 #include "File.hpp"
 #include "Cache.hpp"
+#include "TextureFile.hpp"
 
 namespace Engine3D
 {
@@ -36,33 +39,75 @@ namespace Engine3D
     };
 
     /**
-     * load texture from image
+     * decode png or jpg file
      */
-    InternalTexture textureCacheLoadingFunction(File& input_file)
+    ImageData decodeImage(const std::vector<u8>& buffer)
     {
-        std::vector<u8> buffer = input_file.read();
-        
+        ImageData result;
+
+        if (buffer.empty())
+        {
+            return result;
+        }
+
         //load image
-        SDL_RWops*   handle = SDL_RWFromMem(&buffer[0], buffer.size());
+        SDL_RWops*   handle = SDL_RWFromConstMem(buffer.data(), static_cast<int>(buffer.size()));
         SDL_Surface* img    = IMG_Load_RW(handle, 0);
-        
-        if(img == nullptr)
+
+        SDL_RWclose(handle);
+
+        if (img == nullptr)
         {
-            return { 0, 0, 0 };
+            return result;
         }
-        
+
         //convert image format
         SDL_Surface* img_true = SDL_ConvertSurfaceFormat(img, SDL_PIXELFORMAT_ABGR8888, 0);
-        
-        //create texture and copy data into it
+
+        if (img_true != nullptr)
+        {
+            result.width  = img_true->w;
+            result.height = img_true->h;
+            result.pixels.resize(static_cast<size_t>(result.width) * result.height * 4);
+
+            //the surface rows may be padded
+            for (u32 y = 0; y < result.height; y++)
+            {
+                std::memcpy(&result.pixels[static_cast<size_t>(y) * result.width * 4], static_cast<const u8*>(img_true->pixels) + static_cast<size_t>(y) * img_true->pitch, result.width * 4);
+            }
+
+            SDL_FreeSurface(img_true);
+        }
+
+        SDL_FreeSurface(img);
+
+        return result;
+    }
+
+    /**
+     * decode image on the loading workers, the cooked texture is read instead if it is up to date
+     */
+    ImageData textureCacheDecodingFunction(File& input_file)
+    {
+        return TextureFile::load(input_file);
+    }
+
+    /**
+     * create texture and copy the decoded image into it on the gl thread
+     */
+    InternalTexture textureCacheUploadFunction(ImageData& image)
+    {
+        if (image.pixels.empty())
+        {
+            return { 0, 0, 0 };
+        }
+
         u32 tex = 0;
-        u32 width = img_true->w;
-        u32 height = img_true->h;
 
         glGenTextures(1, &tex);
         glBindTexture(GL_TEXTURE_2D, tex);
         
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, img_true->w, img_true->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, img_true->pixels);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels.data());
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -70,23 +115,30 @@ namespace Engine3D
         
         glBindTexture(GL_TEXTURE_2D, 0);
         
-        SDL_FreeSurface(img);
-        SDL_FreeSurface(img_true);
-        SDL_RWclose(handle);
-        
-        return { width, height, tex };
+        return { image.width, image.height, tex };
     }
     /**
      * clear texture
      */
     void textureCacheClearFunction(InternalTexture& object)
     {
-        glDeleteTextures(1, &object.id);
+        if (object.id != 0)
+        {
+            glDeleteTextures(1, &object.id);
+        }
     }
+    /**
+     * get bytes taken by the texture on the gpu
+     */
+    u64 textureCacheSizeFunction(const InternalTexture& object)
+    {
+        return static_cast<u64>(object.width) * object.height * 4;
+    }
+
     /**
      * cache implementation
      */
-    Cache<InternalTexture> g_texture_cache(textureCacheLoadingFunction, textureCacheClearFunction);
+    Cache<InternalTexture, ImageData> g_texture_cache("textures", textureCacheDecodingFunction, textureCacheUploadFunction, textureCacheClearFunction, textureCacheSizeFunction);
     
     /**
      * load texture into memory
@@ -102,7 +154,7 @@ namespace Engine3D
 
         try
         {
-            g_texture_cache.add(id);
+            m_texture = g_texture_cache.get(id);
         }
         catch (std::runtime_error& e)
         {
@@ -110,12 +162,23 @@ namespace Engine3D
         }
     }
     
+    /**
+     * set bytes the loaded textures may take before the unused ones are freed
+     */
+    void Texture::setCacheBudget(u64 bytes)
+    {
+        g_texture_cache.setBudget(bytes);
+    }
+
     /**
      * delete texture
      */
     void Texture::clean()
     {
-        g_texture_cache.del(m_texture_id);
+        g_texture_cache.del(m_texture);
+
+        m_texture    = {};
+        m_texture_id = "";
     }
 
     /**
@@ -123,19 +186,14 @@ namespace Engine3D
      */
     bool Texture::empty()
     {
-        if (m_texture_id.empty())
+        if (m_texture.valid() == false)
         {
             return true;
         }
 
-        const InternalTexture* tex = g_texture_cache.peek(m_texture_id);
+        const InternalTexture* tex = g_texture_cache.peek(m_texture);
 
-        if (tex == nullptr)
-        {
-            tex = g_texture_cache.get(m_texture_id);
-        }
-
-        if (tex->id == 0)
+        if (tex == nullptr || tex->id == 0)
         {
             return true;
         }
@@ -148,19 +206,14 @@ namespace Engine3D
      */
     u32 Texture::getID()
     {
-        if (m_texture_id.empty())
+        if (m_texture.valid() == false)
         {
             return -1;
         }
 
-        const InternalTexture* tex = g_texture_cache.peek(m_texture_id);
-
-        if (!tex)
-        {
-            tex = g_texture_cache.get(m_texture_id);
-        }
+        const InternalTexture* tex = g_texture_cache.peek(m_texture);
 
-        return tex->id;
+        return tex != nullptr ? tex->id : 0;
     }
 
     /**
@@ -168,17 +221,12 @@ namespace Engine3D
      */
     glm::vec2 Texture::getDims()
     {
-        if (m_texture_id.empty())
+        if (m_texture.valid() == false)
         {
             return glm::vec2(0);
         }
 
-        const InternalTexture* tex = g_texture_cache.peek(m_texture_id);
-
-        if (!tex)
-        {
-            tex = g_texture_cache.get(m_texture_id);
-        }
+        const InternalTexture* tex = g_texture_cache.wait(m_texture);
 
         return glm::vec2(tex->width, tex->height);
     }
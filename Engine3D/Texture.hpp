@@ -17,12 +17,32 @@ along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "Types.hpp"
+#include "Cache.hpp"
 #include "glm/glm.hpp"
 
 namespace Engine3D
 {
+    struct InternalTexture;
+
+    /**
+     * image decoded on the cpu into rgba pixels, the rows go from the top
+     */
+    struct ImageData
+    {
+        u32             width  { 0 };
+        u32             height { 0 };
+        std::vector<u8> pixels;
+    };
+
+    /**
+     * decode png or jpg file, the image is empty if the file can't be decoded,
+     * doesn't touch the gl so it can run on the loading workers
+     */
+    ImageData decodeImage(const std::vector<u8>& buffer);
+
     /**
      * GPU texture
      */
@@ -35,6 +55,20 @@ namespace Engine3D
         Texture(){}
         Texture(const char* id) { init(id); }
         Texture(const std::string& id) { init(id); }
+
+        /**
+         * copies share the texture, each of them holds a reference
+         */
+        Texture(const Texture& other) { init(other.m_texture_id); }
+        Texture& operator=(const Texture& other)
+        {
+            if (this != &other)
+            {
+                clean();
+                init(other.m_texture_id);
+            }
+            return *this;
+        }
         
         /**
          * destructor
@@ -53,25 +87,31 @@ namespace Engine3D
         void clean();
 
         /**
-         * check if the texture is initialized
+         * check if the texture is initialized, it is empty until it is loaded
          */
         bool empty();
         
         /**
-         * get texture ID from OpenGL
+         * get texture ID from OpenGL, 0 until the texture is loaded
          */
         u32 getID();
 
         /**
-         * get texture width and height
+         * get texture width and height, waits for the texture to load
          */
         glm::vec2 getDims();
+
+        /**
+         * set bytes the loaded textures may take, textures no longer used are kept for reuse until the budget runs out
+         */
+        static void setCacheBudget(u64 bytes);
         
     private:
     
         /**
-         * texture management
+         * texture management, the path is kept for the copies, the data is looked up by the handle
          */
-        std::string m_texture_id { "" };
+        std::string                  m_texture_id { "" };
+        CacheHandle<InternalTexture> m_texture;
     };
 };
\ No newline at end of file
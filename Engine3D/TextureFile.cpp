@@ -0,0 +1,142 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TextureFile.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <filesystem>
+
+namespace Engine3D
+{
+    /**
+     * decode the image of the file, the cooked texture is used while it is newer than the source
+     */
+    ImageData TextureFile::load(File& input_file)
+    {
+        const std::string& path = input_file.getPath();
+
+        if (cookedUpToDate(path))
+        {
+            try
+            {
+                return loadCooked(cookedPath(path));
+            }
+            catch (const std::runtime_error& error)
+            {
+                std::printf("Texture() warning: %s\n", error.what());
+            }
+        }
+
+        return decodeImage(input_file.read());
+    }
+
+    /**
+     * map cooked texture and copy the pixels out of it
+     */
+    ImageData TextureFile::loadCooked(const std::string& path)
+    {
+        MappedFile file(path);
+
+        if (file.opened() == false || file.size() < sizeof(Header))
+        {
+            throw std::runtime_error("TextureFile::loadCooked() error: file cannot be mapped: " + path);
+        }
+
+        Header header;
+        std::memcpy(&header, file.data(), sizeof(Header));
+
+        if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version)
+        {
+            throw std::runtime_error("TextureFile::loadCooked() error: not a cooked texture of this version: " + path);
+        }
+
+        u64 size = static_cast<u64>(header.width) * header.height * 4;
+
+        if (size > file.size() - sizeof(Header))
+        {
+            throw std::runtime_error("TextureFile::loadCooked() error: pixels out of the file: " + path);
+        }
+
+        ImageData image;
+
+        image.width  = header.width;
+        image.height = header.height;
+        image.pixels.assign(file.data() + sizeof(Header), file.data() + sizeof(Header) + size);
+
+        return image;
+    }
+
+    /**
+     * write cooked texture
+     */
+    void TextureFile::saveCooked(const ImageData& image, const std::string& path)
+    {
+        if (image.pixels.size() != static_cast<u64>(image.width) * image.height * 4)
+        {
+            throw std::runtime_error("TextureFile::saveCooked() error: pixels don't match the size: " + path);
+        }
+
+        Header header;
+        std::memset(&header, 0, sizeof(Header));
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+
+        header.version = Version;
+        header.width   = image.width;
+        header.height  = image.height;
+
+        std::vector<u8> buffer(sizeof(Header));
+        std::memcpy(buffer.data(), &header, sizeof(Header));
+
+        buffer.insert(buffer.end(), image.pixels.begin(), image.pixels.end());
+
+        File output(path, File::OpenMode::Write);
+
+        if (output.isFile() == false || output.write(buffer) != buffer.size())
+        {
+            throw std::runtime_error("TextureFile::saveCooked() error: file cannot be written: " + path);
+        }
+    }
+
+    /**
+     * get path of the cooked texture made from the source file
+     */
+    std::string TextureFile::cookedPath(const std::string& path)
+    {
+        return path + Extension;
+    }
+
+    /**
+     * check if the cooked texture of the source file exists and isn't older than the source
+     */
+    bool TextureFile::cookedUpToDate(const std::string& path)
+    {
+        //packs hold only the cooked textures made when they were built
+        if (Pack::contains(cookedPath(path)))
+        {
+            return true;
+        }
+
+        std::error_code source_error;
+        std::error_code cooked_error;
+
+        auto source_time = std::filesystem::last_write_time(path, source_error);
+        auto cooked_time = std::filesystem::last_write_time(cookedPath(path), cooked_error);
+
+        return !source_error && !cooked_error && cooked_time >= source_time;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,73 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <string>
+
+#include "Types.hpp"
+#include "File.hpp"
+#include "Texture.hpp"
+
+namespace Engine3D
+{
+    /**
+     * cooked textures, images decoded ahead of time into the rgba pixels the gpu upload takes
+     */
+    namespace TextureFile
+    {
+        /**
+         * cooked texture starts with the header, the rows of the pixels follow it from the top
+         */
+        struct Header
+        {
+            char  magic[4];
+            u32   version;
+            u32   width;
+            u32   height;
+        };
+
+        constexpr char        Magic[4]  = { 'E', '3', 'D', 'T' };
+        constexpr u32         Version   = 1;
+        constexpr const char* Extension = ".e3dtex";
+
+        /**
+         * decode the image of the file, the cooked texture is used while it is newer than the source
+         */
+        ImageData load(File& input_file);
+
+        /**
+         * map cooked texture and copy the pixels out of it
+         */
+        ImageData loadCooked(const std::string& path);
+
+        /**
+         * write cooked texture
+         */
+        void saveCooked(const ImageData& image, const std::string& path);
+
+        /**
+         * get path of the cooked texture made from the source file, the extension is appended
+         * since images of different formats may share the name
+         */
+        std::string cookedPath(const std::string& path);
+
+        /**
+         * check if the cooked texture of the source file exists and isn't older than the source
+         */
+        bool cookedUpToDate(const std::string& path);
+    };
+};
\ No newline at end of file
@@ -0,0 +1,269 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include "Types.hpp"
+
+namespace Engine3D
+{
+    /**
+     * vertex structure
+     */
+    struct Vertex
+    {
+        Vertex() {}
+        Vertex(const glm::vec3& p_pos) : pos(p_pos) {}
+        Vertex(const glm::vec3& p_pos, const glm::vec3& p_nor) : pos(p_pos), nor(p_nor) {}
+        Vertex(const glm::vec3& p_pos, const glm::vec3& p_nor, const glm::vec2& p_uv) : pos(p_pos), nor(p_nor), uv(p_uv) {}
+
+        glm::vec3 pos { 0 };
+        glm::vec3 nor { 1, 0, 0 };
+        glm::vec2 uv  { 0, 0 };
+    };
+
+    /**
+     * layout of the vertices in the gpu buffer
+     */
+    enum class VertexFormat
+    {
+        Float,  //Vertex as it is, 32 bytes
+        Packed  //PackedVertex, 16 bytes
+    };
+
+    /**
+     * compressed gpu vertex, positions are 16 bit normalized (meshes are normalized into [-0.5, 0.5]),
+     * normals are octahedral encoded into two 16 bit normalized values and uv are half floats
+     */
+    struct PackedVertex
+    {
+        s16 pos[4]; //w only pads the normal to 4 bytes
+        s16 nor[2];
+        u16 uv[2];
+    };
+
+    /**
+     * gpu vertices of meshes without uv mapping
+     */
+    struct FloatVertexNoUV
+    {
+        glm::vec3 pos;
+        glm::vec3 nor;
+    };
+
+    struct PackedVertexNoUV
+    {
+        s16 pos[4];
+        s16 nor[2];
+    };
+
+    /**
+     * meaning of a vertex attribute, each one is bound to its own shader attribute
+     */
+    enum class VertexSemantic
+    {
+        Position,
+        Normal,
+        UV
+    };
+
+    /**
+     * type of the attribute components in the gpu buffer
+     */
+    enum class AttributeType
+    {
+        Float,
+        Short,
+        HalfFloat
+    };
+
+    /**
+     * one attribute of a layout
+     */
+    struct VertexAttribute
+    {
+        VertexSemantic semantic;
+        AttributeType  type;
+        u32            count;
+        bool           normalized;
+        u32            offset;
+    };
+
+    /**
+     * encoding shared by the packed layouts
+     */
+    namespace VertexPacking
+    {
+        /**
+         * octahedral encoding, the unit sphere is projected onto an octahedron which is unfolded into [-1, 1]^2
+         */
+        inline glm::vec2 encodeOctahedral(const glm::vec3& normal)
+        {
+            float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+
+            if (length == 0.0f)
+            {
+                return glm::vec2(0.0f);
+            }
+
+            glm::vec3 n = normal / length;
+
+            if (n.z >= 0.0f)
+            {
+                return glm::vec2(n.x, n.y);
+            }
+
+            //the lower half is folded over the diagonals
+            return glm::vec2((1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+                             (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+        }
+
+        /**
+         * fill 16 bit position and octahedral normal, meshes are normalized into [-0.5, 0.5] so the positions need no extra scale
+         */
+        template<typename T>
+        void packPositionNormal(const Vertex& vertex, T& packed)
+        {
+            for (u32 k = 0; k < 3; k++)
+            {
+                packed.pos[k] = static_cast<s16>(glm::packSnorm1x16(vertex.pos[k]));
+            }
+            packed.pos[3] = 0;
+
+            glm::vec2 normal = encodeOctahedral(vertex.nor);
+
+            packed.nor[0] = static_cast<s16>(glm::packSnorm1x16(normal.x));
+            packed.nor[1] = static_cast<s16>(glm::packSnorm1x16(normal.y));
+        }
+    };
+
+    /**
+     * layouts, each one names its gpu vertex type, lists the attributes stored in it
+     * and converts the loaded vertices into it
+     */
+    struct FloatLayout
+    {
+        using Type = Vertex;
+
+        static constexpr std::array<VertexAttribute, 3> Attributes
+        {{
+            { VertexSemantic::Position, AttributeType::Float, 3, false, offsetof(Vertex, pos) },
+            { VertexSemantic::Normal,   AttributeType::Float, 3, false, offsetof(Vertex, nor) },
+            { VertexSemantic::UV,       AttributeType::Float, 2, false, offsetof(Vertex, uv)  }
+        }};
+
+        static Type pack(const Vertex& vertex) { return vertex; }
+    };
+
+    struct FloatNoUVLayout
+    {
+        using Type = FloatVertexNoUV;
+
+        static constexpr std::array<VertexAttribute, 2> Attributes
+        {{
+            { VertexSemantic::Position, AttributeType::Float, 3, false, offsetof(FloatVertexNoUV, pos) },
+            { VertexSemantic::Normal,   AttributeType::Float, 3, false, offsetof(FloatVertexNoUV, nor) }
+        }};
+
+        static Type pack(const Vertex& vertex) { return { vertex.pos, vertex.nor }; }
+    };
+
+    struct PackedLayout
+    {
+        using Type = PackedVertex;
+
+        static constexpr std::array<VertexAttribute, 3> Attributes
+        {{
+            { VertexSemantic::Position, AttributeType::Short,     3, true,  offsetof(PackedVertex, pos) },
+            { VertexSemantic::Normal,   AttributeType::Short,     2, true,  offsetof(PackedVertex, nor) },
+            { VertexSemantic::UV,       AttributeType::HalfFloat, 2, false, offsetof(PackedVertex, uv)  }
+        }};
+
+        static Type pack(const Vertex& vertex)
+        {
+            Type packed;
+            VertexPacking::packPositionNormal(vertex, packed);
+
+            packed.uv[0] = glm::packHalf1x16(vertex.uv.x);
+            packed.uv[1] = glm::packHalf1x16(vertex.uv.y);
+
+            return packed;
+        }
+    };
+
+    struct PackedNoUVLayout
+    {
+        using Type = PackedVertexNoUV;
+
+        static constexpr std::array<VertexAttribute, 2> Attributes
+        {{
+            { VertexSemantic::Position, AttributeType::Short, 3, true, offsetof(PackedVertexNoUV, pos) },
+            { VertexSemantic::Normal,   AttributeType::Short, 2, true, offsetof(PackedVertexNoUV, nor) }
+        }};
+
+        static Type pack(const Vertex& vertex)
+        {
+            Type packed;
+            VertexPacking::packPositionNormal(vertex, packed);
+
+            return packed;
+        }
+    };
+
+    /**
+     * get attribute of the layout, nullptr if the layout doesn't store it
+     */
+    template<typename Layout>
+    constexpr const VertexAttribute* findAttribute(VertexSemantic semantic)
+    {
+        for (const VertexAttribute& attribute : Layout::Attributes)
+        {
+            if (attribute.semantic == semantic)
+            {
+                return &attribute;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * call the function with the layout used for the format, uv are stored only if the mesh has them
+     *
+     * \arg callback - void(Layout), the layout is passed as an empty tag
+     */
+    template<typename F>
+    void visitLayout(VertexFormat format, bool has_uv, F&& callback)
+    {
+        if (format == VertexFormat::Packed)
+        {
+            if (has_uv) { callback(PackedLayout());     }
+            else        { callback(PackedNoUVLayout()); }
+        }
+        else
+        {
+            if (has_uv) { callback(FloatLayout());      }
+            else        { callback(FloatNoUVLayout());  }
+        }
+    }
+};
\ No newline at end of file
@@ -21,16 +21,12 @@ void Asteroid::update(GameLogic* game, const float delta_time)
 {
 	this->rotate(0.01 * delta_time, m_random_rotation);
 
-    /*
-	auto objects = game->spatial_partition().get(this->pos());
-
-    if (objects != nullptr)
+    //keep the asteroid in the spatial partition while it drifts
+    if (this->mov() != glm::vec3(0))
     {
-        for (auto& asteroid : *objects)
-        {
-            Engine3D::Collision::Data collision = Engine3D::Collision::BallVsBall(this->pos(), this->dims().x, asteroid->pos(), asteroid->dims().x);
-            this->pos() += collision.displacement;
-        }
+        Engine3D::BoundingBox old_box = game->spatial_partition().boundingBox(*this);
+        this->pos() += this->mov() * delta_time;
+        game->spatial_partition().move(m_partition_handle, old_box, game->spatial_partition().boundingBox(*this));
     }
-    */
+
 }
\ No newline at end of file
@@ -31,42 +31,14 @@ public:
             Engine3D::Random::uniform(0.1, 1),
             Engine3D::Random::uniform(0.1, 1)
         ));
-
-        m_spatial_partition.init(Engine3D::SpatialPartition<Engine3D::Triangle>::DefaultCellSize, [this](const Engine3D::Triangle& triangle) -> Engine3D::BoundingBox
-            {
-                Engine3D::BoundingBox r;
-
-                r.min.x = std::min(triangle.p1.x, std::min(triangle.p2.x, triangle.p3.x));
-                r.min.y = std::min(triangle.p1.y, std::min(triangle.p2.y, triangle.p3.y));
-                r.min.z = std::min(triangle.p1.z, std::min(triangle.p2.z, triangle.p3.z));
-                                                                                            
-                r.max.x = std::max(triangle.p1.x, std::max(triangle.p2.x, triangle.p3.x));
-                r.max.y = std::max(triangle.p1.y, std::max(triangle.p2.y, triangle.p3.y));
-                r.max.z = std::max(triangle.p1.z, std::max(triangle.p2.z, triangle.p3.z));
-
-                return r;
-            });
-
-        std::vector<Engine3D::Triangle> triangles {};
-        const std::vector<Engine3D::Vertex>* vertices = this->vertices();
-
-        if (vertices->size() != 0)
-        {
-            for (Engine3D::u32 i = 0; i < vertices->size(); i += 3)
-            {
-                triangles.push_back(this->constructTriangle(i));
-            }
-        }
-
-        m_spatial_partition.update(triangles);
 	}
 
 	virtual void update(GameLogic*, const float delta_time) override;
 
-	Engine3D::SpatialPartition<Engine3D::Triangle>& spatial_partition() { return m_spatial_partition; }
+	Engine3D::SpatialPartition<Asteroid>::Handle& partition_handle() { return m_partition_handle; }
 
 private:
 
-	Engine3D::SpatialPartition<Engine3D::Triangle> m_spatial_partition;
+	Engine3D::SpatialPartition<Asteroid>::Handle m_partition_handle { Engine3D::SpatialPartition<Asteroid>::InvalidHandle };
     glm::vec3 m_random_rotation;
 };
\ No newline at end of file
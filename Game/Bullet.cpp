@@ -19,26 +19,54 @@ along with Game.  If not, see <https://www.gnu.org/licenses/>.
 
 void Bullet::update(GameLogic* game, const float delta_time)
 {
-	this->pos() += this->mov() * 0.5f * delta_time;
+    Engine3D::Ray step(this->pos(), this->mov() * 0.5f * delta_time);
 
-    const std::vector<Asteroid*>* asteroids = game->spatial_partition().get(this->pos());
+    //collect asteroids from all cells the bullet passes through during this step
+    Asteroid* asteroids[MaxCandidates];
+    u32       asteroids_count = game->spatial_partition().queryRay(step, asteroids, MaxCandidates);
 
-    if (asteroids != nullptr)
+    this->pos() += step.dir;
+
+    for (u32 i = 0; i < asteroids_count; i++)
     {
-        for (auto& asteroid : *asteroids)
+        Asteroid* asteroid = asteroids[i];
+
+        //asteroids still loading have no triangles yet
+        if (asteroid->ready() == false)
+        {
+            continue;
+        }
+
+        //the whole step is tested, a fast bullet would jump over the asteroid between two frames
+        bool hit = false;
+
+        asteroid->queryTriangles(step, [&](const Engine3D::Triangle& triangle)
+            {
+                hit = Engine3D::Collision::RayVsTriangle(step, triangle).occurred;
+                return hit == false;
+            });
+
+        //the step misses the surface when the bullet only grazes the asteroid with its size
+        if (hit == false)
         {
             Engine3D::Collision::Data collision = Engine3D::Collision::BoxVsBox(this->pos(), this->dims() * this->scale(), asteroid->pos(), asteroid->dims() * asteroid->scale());
-            /*
-            Engine3D::Collision::Data collision = Engine3D::Collision::EllipsoidVsTriangle(this->pos(), this->dims(), triangle->p1, triangle->p2, triangle->p3);
-            */
-            if (collision)
+
+            //the boxes only rule out the far asteroids, the hulls decide
+            if (collision && this->hitbox() == HitboxType::Convex)
             {
-                this->destroy_flag() = true;
-                asteroid->destroy_flag() = true;
-                game->spawn_explosion(asteroid->pos());
-                game->spatial_partition().del(asteroid);
-                return;
+                collision = Engine3D::Collision::MeshVsMeshConvex(this, asteroid);
             }
+
+            hit = collision.occurred;
+        }
+
+        if (hit)
+        {
+            this->destroy_flag() = true;
+            asteroid->destroy_flag() = true;
+            game->spawn_explosion(asteroid->pos());
+            game->spatial_partition().del(asteroid->partition_handle());
+            return;
         }
     }
 }
\ No newline at end of file
@@ -22,11 +22,14 @@ along with Game.  If not, see <https://www.gnu.org/licenses/>.
 class Bullet : public Object
 {
 public:
-	explicit Bullet(const glm::vec3& pos, const glm::vec3& mov) : Object(pos, "data/objects/cube.obj")
+
+	static constexpr const Engine3D::u32 MaxCandidates = 64;
+
+	explicit Bullet(const glm::vec3& pos, const glm::vec3& mov) : Object(pos, "data/objects/cube.obj", HitboxType::Convex)
 	{
 		this->mov() = mov;
 		this->scale() *= 0.2;
 	}
 
-	virtual void update(GameLogic*, const float delta_time) override;
+	virtual void update(GameLogic* game, const float delta_time) override;
 };
\ No newline at end of file
@@ -46,9 +46,17 @@ void GameLogic::init()
             return r;
         });
         
+    //meshes are uploaded with 16 bit positions, octahedral normals and half float uv
+    Engine3D::Mesh::setVertexFormat(Engine3D::VertexFormat::Packed);
+
+    //asset load times and cache hits are written here on exit
+    Engine3D::CacheTelemetry::setDumpPath("cache_telemetry.json");
+
     //load shaders
     Engine3D::inline_try<std::runtime_error>([&]
         {
+            Engine3D::CacheTelemetry::Requester requester("shaders");
+
             m_obj_shader.init("data/shaders/objects.vert", "data/shaders/objects.frag");
             m_image_shader.init("data/shaders/image.vert", "data/shaders/image.frag");
             m_skybox_shader.init("data/shaders/skybox.vert", "data/shaders/skybox_clouds.frag");
@@ -58,6 +66,8 @@ void GameLogic::init()
     //load lights
     Engine3D::inline_try<std::runtime_error>([&]
         {
+            Engine3D::CacheTelemetry::Requester requester("lights");
+
             m_light = new Light(glm::vec3(0), "data/textures/light.png");
             m_light->scale() *= 0.001;
             m_light->diffuse_color() = m_light->specular_color() = glm::vec3(0.9, 0.1, 0.5);
@@ -73,10 +83,14 @@ void GameLogic::init()
     //load textures
     Engine3D::inline_try<std::runtime_error>([&]
         {
+            Engine3D::CacheTelemetry::Requester requester("skybox");
+
             m_skybox_texture.init("data/textures/skybox");
         }, "GameLogic::Engine3D_init()");
     Engine3D::inline_try<std::runtime_error>([&]
         {
+            Engine3D::CacheTelemetry::Requester requester("skybox");
+
             m_skybox_noise.init("data/textures/noise256.png");
         }, "GameLogic::Engine3D_init()");
 
@@ -86,6 +100,8 @@ void GameLogic::init()
     //load skybox
     Engine3D::inline_try<std::runtime_error>([&]
         {
+            Engine3D::CacheTelemetry::Requester requester("skybox");
+
             m_skybox.init(glm::vec3(0), "data/objects/inv_cube.obj");
             m_skybox.scale() = glm::vec3(this->DefaultFrustrumMax / sqrtf(3));
             m_skybox.setupVertexAttributes(m_skybox_shader);
@@ -94,6 +110,8 @@ void GameLogic::init()
     //load level
     Engine3D::inline_try<std::runtime_error>([&]
         {
+            Engine3D::CacheTelemetry::Requester requester("asteroids");
+
             const char* asteroids_models[] = {
                 "data/objects/rock.obj",
                 "data/objects/island.obj",
@@ -108,7 +126,10 @@ void GameLogic::init()
                                                            -20 + Engine3D::Random::uniform(-100, 100), 
                                                            -20 + Engine3D::Random::uniform(-10, 100)), glm::vec3(0), asteroids_models[asteroids_model_index]));
                 m_objects.back()->scale() = glm::vec3(2 + Engine3D::Random::uniform(0, 5));
-                m_objects.back()->hitbox() = Object::HitboxType::Mesh;
+                //cubes are their own hull, the cheap convex test is exact for them
+                m_objects.back()->hitbox() = asteroids_model_index == 2 ? Object::HitboxType::Convex : Object::HitboxType::Mesh;
+                //asteroids collide with the collision mesh, the render copy isn't needed in ram
+                m_objects.back()->discardVertices();
 m_objects.back()->setupVertexAttributes(m_obj_shader);
 m_objects.back()->col() = glm::vec3(Engine3D::Random::uniform(0.2, 0.6), Engine3D::Random::uniform(0.2, 0.4), Engine3D::Random::uniform(0.0, 0.05));
             }
@@ -140,20 +161,19 @@ m_objects.back()->col() = glm::vec3(Engine3D::Random::uniform(0.2, 0.6), Engine3
 
         //construct spatial partition
 
-        std::vector<Asteroid*> asteroids;
+        m_spatial_partition.clear();
 
         for (auto& object : m_objects)
         {
-            if (object->hitbox() != Object::HitboxType::Mesh)
+            if (object->hitbox() != Object::HitboxType::Mesh && object->hitbox() != Object::HitboxType::Convex)
             {
                 continue;
             }
 
-            asteroids.push_back(reinterpret_cast<Asteroid*>(object));
+            Asteroid* asteroid = reinterpret_cast<Asteroid*>(object);
+            asteroid->partition_handle() = m_spatial_partition.add(asteroid);
         }
 
-        m_spatial_partition.update(asteroids);
-
         std::printf("GameLogic() log: spatial partitions constructed\n");
         std::printf("--------------------\n");
         std::printf("Controls: W, A, S, D\n");
@@ -255,23 +275,43 @@ void GameLogic::update(const float time_delta)
         
         glm::vec3 collision_result(0);
 
-        //perform collision with static objects
+        //perform collision with static objects in all cells covered by the player's ellipsoid
 
-        auto asteroids = m_spatial_partition.get(m_player->pos());
+        Engine3D::BoundingBox player_box(m_player->pos() - m_player->dims(), m_player->pos() + m_player->dims());
 
-        if (asteroids != nullptr)
-        {
-            for (auto& asteroid : *asteroids)
+        //triangles are tested in blocks, the block test moves the player the same way testing them one by one would
+        Engine3D::TriangleBlock triangle_block;
+
+        auto collide_triangle_block = [&]()
             {
-                auto triangles = asteroid->triangles();
+                Engine3D::Collision::Data collision = Engine3D::Collision::EllipsoidVsTriangleBlock(m_player->pos(), m_player->dims(), triangle_block);
+                collision_result += collision.displacement;
+                triangle_block.clear();
+            };
 
-                for (auto& triangle : triangles)
+        m_spatial_partition.queryBox(player_box, [&](Asteroid* asteroid)
+            {
+                //asteroids still loading have no triangles yet, waiting for them would stall the frame
+                if (asteroid->ready() == false)
                 {
-                    Engine3D::Collision::Data collision = Engine3D::Collision::EllipsoidVsTriangle(m_player->pos(), m_player->dims(), triangle.p1, triangle.p2, triangle.p3);
-                    m_player->pos() += collision.displacement;
-                    collision_result += collision.displacement;
+                    return;
                 }
-            }
+
+                //only triangles near the player are extracted from the asteroid's hierarchy
+                asteroid->queryTriangles(player_box, [&](const Engine3D::Triangle& triangle)
+                    {
+                        triangle_block.push(triangle);
+
+                        if (triangle_block.full())
+                        {
+                            collide_triangle_block();
+                        }
+                    });
+            });
+
+        if (triangle_block.empty() == false)
+        {
+            collide_triangle_block();
         }
 
         if (m_objects_to_insert.size() != 0)
@@ -300,7 +340,8 @@ void GameLogic::update(const float time_delta)
                 }
                 return true;
             }), m_objects.end());
-            
+
+        collide_objects();
         
         static u32 cicler = 0;
 
@@ -338,6 +379,8 @@ void GameLogic::draw()
 {
     
     this->drawBegin3D(m_player->getCam());
+
+    float lod_scale = this->lodScale();
     
     //draw skybox
     m_skybox_shader.use();
@@ -348,7 +391,8 @@ void GameLogic::draw()
     m_skybox_shader.set3f(glm::vec3(0.5, 0.5, 1), "color");
     m_skybox_shader.set1f(m_time / 100.0f, "time");
 
-    m_skybox.draw();
+    //the sky is always drawn in full
+    m_skybox.draw(m_player->getCam(), 0.0f);
 
     m_skybox_shader.unuse();
 
@@ -399,8 +443,9 @@ void GameLogic::draw()
         m_obj_shader.set4x4m(m_player->getCam().getViewMatrix(), "view_mat");
         m_obj_shader.set1f(m_time / 100.0f, "time");
         m_obj_shader.set3f(object->pos(), "obj_pos");
+        m_obj_shader.set1b(object->vertexFormat() == Engine3D::VertexFormat::Packed, "packed_normals");
 
-        object->draw();
+        object->draw(m_player->getCam(), lod_scale);
 
         m_obj_shader.unuse();
     }
@@ -448,8 +493,9 @@ void GameLogic::draw()
     m_obj_shader.set4x4m(m_player->getCam().getViewMatrix(), "view_mat");
     m_obj_shader.set1f(m_time / 100.0f, "time");
     m_obj_shader.set3f(m_player->pos(), "obj_pos");
+    m_obj_shader.set1b(m_player->vertexFormat() == Engine3D::VertexFormat::Packed, "packed_normals");
 
-    m_player->draw();
+    m_player->draw(m_player->getCam(), lod_scale);
 
     m_obj_shader.unuse();
 
@@ -489,6 +535,83 @@ void GameLogic::click()
     this->setVSync(vsync);
 }
 
+void GameLogic::collide_objects()
+{
+    m_broadphase_boxes.clear();
+    m_broadphase_objects.clear();
+
+    //gather bounding boxes of the asteroids, bullets ray-march the partition themselves
+    for (auto object : m_objects)
+    {
+        Asteroid* asteroid = dynamic_cast<Asteroid*>(object);
+
+        //asteroids whose mesh is loading or failed to load don't collide yet
+        if (asteroid == nullptr || asteroid->destroy_flag() || asteroid->hitbox() == Object::HitboxType::None || asteroid->ready() == false)
+        {
+            continue;
+        }
+
+        Engine3D::Box box = asteroid->boundingBox();
+
+        m_broadphase_boxes.push_back(Engine3D::BoundingBox(box.pos - box.dims / 2.0f, box.pos + box.dims / 2.0f));
+        m_broadphase_objects.push_back(asteroid);
+    }
+
+    //resolve asteroid vs asteroid pairs, only drifting asteroids get pushed apart
+    for (auto& pair : m_broadphase.update(m_broadphase_boxes))
+    {
+        Asteroid* first  = m_broadphase_objects[pair.first];
+        Asteroid* second = m_broadphase_objects[pair.second];
+
+        bool first_moves  = first->mov()  != glm::vec3(0);
+        bool second_moves = second->mov() != glm::vec3(0);
+
+        //static asteroids never push each other
+        if (first_moves == false && second_moves == false)
+        {
+            continue;
+        }
+
+        Engine3D::Collision::Data collision;
+
+        //convex asteroids are pushed out of the other hull, the rest keeps the bounding balls
+        if (first->hitbox() == Object::HitboxType::Convex || second->hitbox() == Object::HitboxType::Convex)
+        {
+            collision = Engine3D::Collision::MeshVsMeshConvex(first, second);
+        }
+        else
+        {
+            //the balls hold the furthest vertex in every direction, furthest_vertex_value * the largest scale
+            glm::vec3 first_dims  = m_broadphase_boxes[pair.first].max  - m_broadphase_boxes[pair.first].min;
+            glm::vec3 second_dims = m_broadphase_boxes[pair.second].max - m_broadphase_boxes[pair.second].min;
+
+            collision = Engine3D::Collision::BallVsBall(first->pos(),  std::max(first_dims.x,  std::max(first_dims.y,  first_dims.z))  / 2.0f,
+                                                        second->pos(), std::max(second_dims.x, std::max(second_dims.y, second_dims.z)) / 2.0f);
+        }
+
+        if (collision.occurred == false)
+        {
+            continue;
+        }
+
+        float share = (first_moves && second_moves) ? 0.5f : 1.0f;
+
+        if (first_moves)
+        {
+            Engine3D::BoundingBox old_box = m_spatial_partition.boundingBox(*first);
+            first->pos() += collision.displacement * share;
+            m_spatial_partition.move(first->partition_handle(), old_box, m_spatial_partition.boundingBox(*first));
+        }
+
+        if (second_moves)
+        {
+            Engine3D::BoundingBox old_box = m_spatial_partition.boundingBox(*second);
+            second->pos() -= collision.displacement * share;
+            m_spatial_partition.move(second->partition_handle(), old_box, m_spatial_partition.boundingBox(*second));
+        }
+    }
+}
+
 void GameLogic::spawn_explosion(const glm::vec3& pos)
 {
     for (u32 i = 0; i < 30; i++)
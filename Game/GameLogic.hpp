@@ -57,12 +57,20 @@ public:
     std::vector<Object*>& objects() { return m_objects; }
 
 private:
+
+    /**
+     * collect candidate pairs of colliding objects and resolve them
+     */
+    void collide_objects();
     
     std::vector<Object*>                 m_objects_to_insert;
     std::vector<Object*>                 m_objects;
     std::array<Light*, 20>               m_player_trail;
     std::unique_ptr<Player>              m_player;
     Engine3D::SpatialPartition<Asteroid> m_spatial_partition;
+    Engine3D::Broadphase                 m_broadphase;
+    std::vector<Engine3D::BoundingBox>   m_broadphase_boxes;
+    std::vector<Asteroid*>               m_broadphase_objects;
 
     Light* m_light;
 
@@ -33,7 +33,8 @@ public:
         Box,
         Cylinder,
         Ball,
-        Mesh
+        Mesh,
+        Convex
     };
 
     /**
@@ -0,0 +1,445 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <map>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+
+#include <SDL2/SDL_image.h>
+
+#include "Engine3D/File.hpp"
+#include "Engine3D/MeshFile.hpp"
+#include "Engine3D/TextureFile.hpp"
+#include "Engine3D/ShaderFile.hpp"
+
+using namespace Engine3D;
+
+/**
+ * cooked asset in the database
+ *
+ * the database is a text file, each asset starts with its line and the lines of its inputs and references follow
+ *
+ *   mesh    data/objects/rock.obj    data/objects/rock.e3dmesh    6
+ *   input   data/objects/rock.obj    <hash>
+ *   input   data/objects/rock.mtl    <hash>
+ *   input   data/objects/rock_col.obj -
+ *   uses    data/objects/rock.png
+ *
+ * the number is the version of the cooked format, inputs are the files the cooked asset is made from,
+ * a missing optional one has no hash, references are the assets the cooked asset loads at runtime
+ */
+struct Record
+{
+    std::string                                      type;
+    std::string                                      output;
+    u32                                              version { 0 };
+    std::vector<std::pair<std::string, std::string>> inputs; //path and hash
+    std::vector<std::string>                         references;
+};
+
+constexpr const char* DefaultDirectory = "data";
+constexpr const char* DefaultDatabase  = "cook.db";
+constexpr const char* MissingHash      = "-";
+
+/**
+ * check if the name ends with the suffix
+ */
+static bool endsWith(const std::string& name, const std::string& suffix)
+{
+    return name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/**
+ * get 64 bit fnv-1a hash of the file content in hex, MissingHash if the file can't be read
+ */
+static std::string hashFile(const std::string& path)
+{
+    File input(path);
+
+    if (input.isFile() == false)
+    {
+        return MissingHash;
+    }
+
+    u64 hash = 14695981039346656037ull;
+
+    for (u8 byte : input.read())
+    {
+        hash = (hash ^ byte) * 1099511628211ull;
+    }
+
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(hash));
+
+    return text;
+}
+
+/**
+ * get material files the .obj file names in its mtllib lines, they are found next to it like MeshFile::loadObj() does
+ */
+static std::vector<std::string> materialFiles(const std::string& path)
+{
+    std::vector<std::string> result;
+
+    File        input(path);
+    std::string text   = input.isFile() ? input.readText() : "";
+    std::string folder = path.substr(0, path.find_last_of("/\\"));
+    u64         start  = 0;
+
+    while (start < text.size())
+    {
+        u64         end  = std::min(text.find('\n', start), text.size());
+        std::string line = text.substr(start, end - start);
+
+        start = end + 1;
+
+        if (line.compare(0, 7, "mtllib ") != 0)
+        {
+            continue;
+        }
+
+        u64 begin = line.find_first_not_of(" \t", 7);
+        u64 last  = line.find_last_not_of(" \t\r");
+
+        if (begin != std::string::npos)
+        {
+            result.push_back(folder + "/" + line.substr(begin, last - begin + 1));
+        }
+    }
+
+    return result;
+}
+
+/**
+ * get version of the cooked format of the asset type, the asset is cooked again when it changes
+ */
+static u32 formatVersion(const std::string& type)
+{
+    if (type == "mesh")
+    {
+        return MeshFile::Version;
+    }
+    if (type == "texture")
+    {
+        return TextureFile::Version;
+    }
+
+    return ShaderFile::Version;
+}
+
+/**
+ * check if the runtime would load the cooked asset instead of its source, it decides by the file times
+ */
+static bool cookedUpToDate(const std::string& type, const std::string& path)
+{
+    if (type == "mesh")
+    {
+        return MeshFile::cookedUpToDate(path);
+    }
+    if (type == "texture")
+    {
+        return TextureFile::cookedUpToDate(path);
+    }
+
+    return ShaderFile::cookedUpToDate(path);
+}
+
+/**
+ * read the database, it is empty if there is none
+ */
+static std::map<std::string, Record> loadDatabase(const std::string& path)
+{
+    std::map<std::string, Record> result;
+
+    File input(path);
+
+    if (input.isFile() == false)
+    {
+        return result;
+    }
+
+    std::string text  = input.readText();
+    Record*     asset = nullptr;
+    u64         start = 0;
+
+    while (start < text.size())
+    {
+        u64         end  = std::min(text.find('\n', start), text.size());
+        std::string line = text.substr(start, end - start);
+
+        std::vector<std::string> fields;
+
+        for (u64 field = start; field <= end; )
+        {
+            u64 tab = std::min(text.find('\t', field), end);
+
+            fields.push_back(text.substr(field, tab - field));
+            field = tab + 1;
+        }
+
+        start = end + 1;
+
+        if (fields.size() == 3 && fields[0] == "input" && asset != nullptr)
+        {
+            asset->inputs.emplace_back(fields[1], fields[2]);
+        }
+        else if (fields.size() == 2 && fields[0] == "uses" && asset != nullptr)
+        {
+            asset->references.push_back(fields[1]);
+        }
+        //records written before the versions were stored get version 0 and are cooked again
+        else if ((fields.size() == 3 || fields.size() == 4) && fields[0] != "input")
+        {
+            asset = &result[fields[1]];
+            asset->type    = fields[0];
+            asset->output  = fields[2];
+            asset->version = fields.size() == 4 ? static_cast<u32>(std::strtoul(fields[3].c_str(), nullptr, 10)) : 0;
+        }
+        else if (fields.size() > 1 || fields[0].empty() == false)
+        {
+            std::printf("Cook() warning: unknown line in the database: %s\n", line.c_str());
+            asset = nullptr;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * write the database
+ */
+static void saveDatabase(const std::map<std::string, Record>& database, const std::string& path)
+{
+    std::string text;
+
+    for (auto& [source, asset] : database)
+    {
+        text += asset.type + "\t" + source + "\t" + asset.output + "\t" + std::to_string(asset.version) + "\n";
+
+        for (auto& [input, hash] : asset.inputs)
+        {
+            text += "input\t" + input + "\t" + hash + "\n";
+        }
+        for (auto& reference : asset.references)
+        {
+            text += "uses\t" + reference + "\n";
+        }
+    }
+
+    File output(path, File::OpenMode::Write);
+
+    if (output.isFile() == false || output.write(text) != text.size())
+    {
+        throw std::runtime_error("file cannot be written: " + path);
+    }
+}
+
+/**
+ * cook the source into the output, return the assets the output references
+ */
+static std::vector<std::string> cook(const std::string& type, const std::string& path, const std::string& output)
+{
+    File input(path);
+
+    if (input.isFile() == false)
+    {
+        throw std::runtime_error("file cannot be opened");
+    }
+
+    if (type == "mesh")
+    {
+        MeshData data = MeshFile::loadObj(input);
+        MeshFile::saveCooked(data, output);
+
+        return data.diffuse_map.empty() ? std::vector<std::string>() : std::vector<std::string> { data.diffuse_map };
+    }
+
+    if (type == "texture")
+    {
+        ImageData image = decodeImage(input.read());
+
+        if (image.pixels.empty())
+        {
+            throw std::runtime_error("image cannot be decoded");
+        }
+
+        TextureFile::saveCooked(image, output);
+    }
+    else
+    {
+        std::string text = ShaderFile::cook(input.readText());
+        File        cooked(output, File::OpenMode::Write);
+
+        if (cooked.isFile() == false || cooked.write(text) != text.size())
+        {
+            throw std::runtime_error("file cannot be written: " + output);
+        }
+    }
+
+    return {};
+}
+
+/**
+ * cooker state shared by the walk
+ */
+struct Cooker
+{
+    std::map<std::string, Record> previous;
+    std::map<std::string, Record> database;
+    u32                           cooked  { 0 };
+    u32                           skipped { 0 };
+    u32                           failed  { 0 };
+};
+
+/**
+ * cook the asset unless the hashes of its inputs match the database and the runtime takes its output as up to date
+ */
+static void cookAsset(Cooker& cooker, const std::string& type, const std::string& path, const std::string& output)
+{
+    Record asset;
+
+    asset.type    = type;
+    asset.output  = output;
+    asset.version = formatVersion(type);
+    asset.inputs.emplace_back(path, hashFile(path));
+
+    if (type == "mesh")
+    {
+        for (auto& material : materialFiles(path))
+        {
+            asset.inputs.emplace_back(material, hashFile(material));
+        }
+
+        asset.inputs.emplace_back(MeshFile::collisionPath(path), hashFile(MeshFile::collisionPath(path)));
+    }
+
+    auto previous = cooker.previous.find(path);
+
+    //inputs with newer times are cooked again even if their content is the same, the runtime would read the sources otherwise
+    if (previous != cooker.previous.end() && previous->second.type == type && previous->second.output == output &&
+        previous->second.version == asset.version && previous->second.inputs == asset.inputs && cookedUpToDate(type, path))
+    {
+        cooker.database[path] = previous->second;
+        cooker.skipped++;
+        return;
+    }
+
+    try
+    {
+        asset.references = cook(type, path, output);
+        cooker.database[path] = std::move(asset);
+        cooker.cooked++;
+
+        std::printf("Cook() log: %s -> %s\n", path.c_str(), output.c_str());
+    }
+    catch (const std::runtime_error& error)
+    {
+        std::printf("Cook() error: %s: %s\n", path.c_str(), error.what());
+        cooker.failed++;
+    }
+}
+
+/**
+ * cook every asset in the directory and its subdirectories
+ */
+static void cookDirectory(Cooker& cooker, const std::string& path)
+{
+    File directory(path);
+
+    for (auto& name : directory.list())
+    {
+        std::string file_path = path + "/" + name;
+
+        if (name == "." || name == "..")
+        {
+            continue;
+        }
+        else if (std::filesystem::is_directory(file_path))
+        {
+            cookDirectory(cooker, file_path);
+        }
+        //collision meshes are inputs of the meshes they belong to
+        else if (endsWith(name, ".obj") && endsWith(name, std::string(MeshFile::CollisionSuffix) + ".obj") == false)
+        {
+            cookAsset(cooker, "mesh", file_path, MeshFile::cookedPath(file_path));
+        }
+        else if (endsWith(name, ".png") || endsWith(name, ".jpg") || endsWith(name, ".jpeg"))
+        {
+            cookAsset(cooker, "texture", file_path, TextureFile::cookedPath(file_path));
+        }
+        else if (endsWith(name, ".vert") || endsWith(name, ".frag"))
+        {
+            cookAsset(cooker, "shader", file_path, ShaderFile::cookedPath(file_path));
+        }
+    }
+}
+
+/**
+ * entry point, cooks the assets of the directory into the files next to them,
+ * run it from the executable folder of the game, "Cook data cook.db"
+ *
+ * the runtime uses a cooked file only while it is newer than its sources, a checkout touching the sources
+ * makes the game read them until Cook is run again
+ */
+int main(int argc, const char* argv[])
+{
+    std::string directory = argc > 1 ? argv[1] : DefaultDirectory;
+    std::string database  = argc > 2 ? argv[2] : DefaultDatabase;
+
+    if (argc > 3 || std::filesystem::is_directory(directory) == false)
+    {
+        std::printf("usage: %s [directory] [database], defaults: %s %s\n", argv[0], DefaultDirectory, DefaultDatabase);
+        return 1;
+    }
+
+    IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+
+    Cooker cooker;
+    cooker.previous = loadDatabase(database);
+
+    cookDirectory(cooker, directory);
+
+    //assets whose cooking failed keep their last record so they are cooked again
+    for (auto& [source, asset] : cooker.previous)
+    {
+        if (cooker.database.count(source) == 0 && std::filesystem::exists(source))
+        {
+            cooker.database[source] = asset;
+        }
+    }
+
+    try
+    {
+        saveDatabase(cooker.database, database);
+    }
+    catch (const std::runtime_error& error)
+    {
+        std::printf("Cook() error: %s\n", error.what());
+        return 1;
+    }
+
+    IMG_Quit();
+
+    std::printf("Cook() log: %u cooked, %u up to date, %u failed\n", cooker.cooked, cooker.skipped, cooker.failed);
+
+    return cooker.failed == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "Engine3D/File.hpp"
+#include "Engine3D/MeshFile.hpp"
+
+using namespace Engine3D;
+
+/**
+ * cook one .obj file next to its source, return false on failure
+ */
+static bool cook(const std::string& path)
+{
+    try
+    {
+        File input(path);
+
+        if (input.isFile() == false)
+        {
+            std::printf("MeshCooker() error: file cannot be opened: %s\n", path.c_str());
+            return false;
+        }
+
+        MeshData data = MeshFile::loadObj(input);
+        input.close();
+
+        std::string cooked_path = MeshFile::cookedPath(path);
+        MeshFile::saveCooked(data, cooked_path);
+
+        std::printf("MeshCooker() log: %s -> %s\n", path.c_str(), cooked_path.c_str());
+    }
+    catch (const std::runtime_error& error)
+    {
+        std::printf("MeshCooker() error: %s: %s\n", path.c_str(), error.what());
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * check if the file is the collision mesh of another one, it is cooked into the mesh of its source
+ */
+static bool isCollisionMesh(const std::string& name)
+{
+    std::string suffix = std::string(MeshFile::CollisionSuffix) + ".obj";
+
+    return name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/**
+ * entry point, every argument is an .obj file or a directory whose .obj files are cooked
+ */
+int main(int argc, const char* argv[])
+{
+    if (argc < 2)
+    {
+        std::printf("usage: %s <file.obj | directory> ...\n", argv[0]);
+        return 1;
+    }
+
+    u32 failed = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string path = argv[i];
+        File        input(path);
+
+        if (input.isDir())
+        {
+            for (auto& name : input.list())
+            {
+                if (name.size() > 4 && name.compare(name.size() - 4, 4, ".obj") == 0 && isCollisionMesh(name) == false)
+                {
+                    failed += cook(path + "/" + name) ? 0 : 1;
+                }
+            }
+        }
+        else
+        {
+            input.close();
+            failed += cook(path) ? 0 : 1;
+        }
+    }
+
+    return failed == 0 ? 0 : 1;
+}
\ No newline at end of file
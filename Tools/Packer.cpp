@@ -0,0 +1,112 @@
+/*
+This file is part of Engine3D.
+
+Engine3D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Engine3D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Engine3D.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "Engine3D/File.hpp"
+#include "Engine3D/Pack.hpp"
+
+using namespace Engine3D;
+
+/**
+ * check if the name ends with the suffix
+ */
+static bool endsWith(const std::string& name, const std::string& suffix)
+{
+    return name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/**
+ * add the file or every file in the directory and its subdirectories, the path is the name in the pack
+ */
+static u32 add(Pack::Writer& writer, const std::string& path)
+{
+    File input(path);
+
+    if (input.isDir())
+    {
+        u32 count = 0;
+
+        for (auto& name : input.list())
+        {
+            //packs aren't packed into each other
+            if (name != "." && name != ".." && endsWith(name, Pack::Extension) == false)
+            {
+                count += add(writer, path + "/" + name);
+            }
+        }
+
+        return count;
+    }
+
+    if (input.isFile() == false)
+    {
+        throw std::runtime_error("file cannot be opened: " + path);
+    }
+
+    std::vector<u8> data = input.read();
+    writer.add(path, data);
+
+    std::printf("Packer() log: %s (%llu bytes)\n", path.c_str(), static_cast<unsigned long long>(data.size()));
+
+    return 1;
+}
+
+/**
+ * entry point, every argument after the pack is a file or a directory packed with its relative path,
+ * run it from the executable folder of the game, "Packer data.e3dpack data"
+ */
+int main(int argc, const char* argv[])
+{
+    if (argc < 3)
+    {
+        std::printf("usage: %s <output%s> <file | directory> ...\n", argv[0], Pack::Extension);
+        return 1;
+    }
+
+    try
+    {
+        Pack::Writer writer;
+        u32          count = 0;
+
+        for (int i = 2; i < argc; i++)
+        {
+            std::string path = argv[i];
+
+            //trailing separators would end up in the names
+            while (path.size() > 1 && (path.back() == '/' || path.back() == '\\'))
+            {
+                path.pop_back();
+            }
+
+            count += add(writer, path);
+        }
+
+        writer.save(argv[1]);
+
+        std::printf("Packer() log: %u files -> %s\n", count, argv[1]);
+    }
+    catch (const std::runtime_error& error)
+    {
+        std::printf("Packer() error: %s\n", error.what());
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
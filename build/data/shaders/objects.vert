@@ -10,12 +10,24 @@ varying vec3 coord;
 varying vec3 color;
 varying vec2 uv;
 
+uniform bool packed_normals;
+
+/**
+ * \brief decode octahedral normal, the lower half of the sphere is folded over the diagonals
+ */
+vec3 decodeNormal(vec2 e) {
+    vec3  n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy   += t * (1.0 - 2.0 * step(0.0, n.xy));
+    return normalize(n);
+}
+
 void main() {
 
     gl_Position   = gl_ModelViewProjectionMatrix * vec4(in_pos, 1.0);
 	position      = vec3(gl_ModelViewMatrix * vec4(in_pos, 1.0));
 	
-	normal = gl_NormalMatrix * in_nor;
+	normal = gl_NormalMatrix * (packed_normals ? decodeNormal(in_nor.xy) : in_nor);
     coord  = in_pos;
 	uv     = in_uv;
 }